@@ -3,14 +3,106 @@
 import 'dart:ffi';
 import 'dart:io';
 
+import 'package:ffi/ffi.dart';
+import 'package:game_of_life/data/cell_deltas.dart';
 import 'package:game_of_life/data/gol_data.dart';
+import 'package:game_of_life/data/gol_stats.dart';
+import 'package:game_of_life/data/input_grid.dart';
+import 'package:game_of_life/data/output_grid.dart';
+import 'package:game_of_life/data/pixel_buffer.dart';
 
 typedef _nativeInit = Void Function(Int32 rows, Int32 cols, Double cellSize);
 typedef _dartInit = void Function(int rows, int cols, double cellSize);
 
+typedef _nativeInitFrom = Void Function(Int32 rows, Int32 cols,
+    Double cellSize, Pointer<Void> cells, Int32 format);
+typedef _dartInitFrom = void Function(
+    int rows, int cols, double cellSize, Pointer<Void> cells, int format);
+
+/// GolCellFormat of an [InputGrid] buffer, see cppSeed.hpp.
+const int _cellFormatFloats = 2;
+
 typedef _nativeUpdate = Pointer<Float> Function();
 typedef _dartUpdate = Pointer<Float> Function();
 
+typedef _nativeUpdateCounted = Pointer<Float> Function(Pointer<Int64> count);
+typedef _dartUpdateCounted = Pointer<Float> Function(Pointer<Int64> count);
+
+typedef _nativeUpdateDeltas = Void Function(Pointer<Pointer<Float>> born,
+    Pointer<Int64> bornCount, Pointer<Pointer<Float>> died,
+    Pointer<Int64> diedCount);
+typedef _dartUpdateDeltas = void Function(Pointer<Pointer<Float>> born,
+    Pointer<Int64> bornCount, Pointer<Pointer<Float>> died,
+    Pointer<Int64> diedCount);
+
+typedef _nativeAliveCount = Int64 Function();
+typedef _dartAliveCount = int Function();
+
+typedef _nativeGetStats = Void Function(Pointer<NativeGolStats> out);
+typedef _dartGetStats = void Function(Pointer<NativeGolStats> out);
+
+typedef _nativeResetStats = Void Function();
+typedef _dartResetStats = void Function();
+
+typedef _nativeStep = Void Function(Int32 generations);
+typedef _dartStep = void Function(int generations);
+
+typedef _nativeCollect = Pointer<Float> Function();
+typedef _dartCollect = Pointer<Float> Function();
+
+typedef _nativeSetRate = Void Function(Double gensPerSecond);
+typedef _dartSetRate = void Function(double gensPerSecond);
+
+typedef _nativeLatestFrame = Pointer<Float> Function(Pointer<Int64> count,
+    Pointer<Int32> pointFloats, Pointer<Int32> lod, Pointer<Uint64> generation);
+typedef _dartLatestFrame = Pointer<Float> Function(Pointer<Int64> count,
+    Pointer<Int32> pointFloats, Pointer<Int32> lod, Pointer<Uint64> generation);
+
+typedef _nativeApplyEdits = Void Function(
+    Pointer<Int32> xy, Pointer<Uint8> states, Int32 n);
+typedef _dartApplyEdits = void Function(
+    Pointer<Int32> xy, Pointer<Uint8> states, int n);
+
+typedef _nativeSetViewport = Void Function(
+    Int32 x0, Int32 y0, Int32 x1, Int32 y1);
+typedef _dartSetViewport = void Function(int x0, int y0, int x1, int y1);
+
+typedef _nativeSetLod = Void Function(Int32 level);
+typedef _dartSetLod = void Function(int level);
+
+typedef _nativeRender = Void Function(
+    Pointer<Uint8> pixels,
+    Int32 width,
+    Int32 height,
+    Int32 format,
+    Double cellPixels,
+    Double zoom,
+    Double offsetX,
+    Double offsetY,
+    Uint32 aliveColor,
+    Uint32 deadColor);
+typedef _dartRender = void Function(
+    Pointer<Uint8> pixels,
+    int width,
+    int height,
+    int format,
+    double cellPixels,
+    double zoom,
+    double offsetX,
+    double offsetY,
+    int aliveColor,
+    int deadColor);
+
+/// GolPixelFormat of a [PixelBuffer], see cppRaster.hpp.
+const int _pixelFormatRgba8 = 0;
+
+typedef _nativeSetPointFormat = Int32 Function(Int32 format);
+typedef _dartSetPointFormat = int Function(int format);
+
+/// GolPointFormat values, see cppPoints.hpp.
+const int _pointFormatFloats = 0;
+const int _pointFormatCells = 1;
+
 typedef _nativeDestruct = Void Function();
 typedef _dartDestruct = void Function();
 
@@ -18,21 +110,109 @@ class CppComputer {
   late DynamicLibrary nativeLib;
 
   late Function nativeInit;
+  late Function nativeInitFrom;
   late Function nativeUpdate;
+  late Function nativeUpdateCounted;
+  late Function nativeUpdateDeltas;
+  late Function nativeAliveCount;
+  late Function nativeGetStats;
+  late Function nativeResetStats;
+  late Function nativeStep;
+  late Function nativeCollect;
+  late Function nativeApplyEdits;
+  late Function nativeSetViewport;
+  late Function nativeSetLod;
+  late Function nativeSetPointFormat;
+  late Function nativeRender;
+  late Function nativeStartAsync;
+  late Function nativeSetTargetRate;
+  late Function nativeLatestFrame;
+  late Function nativeStopAsync;
   late Function nativeDestruct;
 
-  CppComputer(int rows, int cols, double cellSize) {
+  /// Whether a native thread is stepping the grid, see [startAsync].
+  bool _async = false;
+
+  /// Density level of the native output, see [setLod].
+  int _lod = 0;
+
+  /// Whether the native output is packed cells, see [setPackedOutput].
+  bool _packed = false;
+
+  /// Receives the live cell count from [nativeUpdateCounted].
+  final Pointer<Int64> _count = malloc<Int64>();
+
+  /// Receive the layout of a frame from [nativeLatestFrame], which may
+  /// predate the last [setLod] or [setPackedOutput].
+  final Pointer<Int32> _pointFloats = malloc<Int32>();
+  final Pointer<Int32> _frameLod = malloc<Int32>();
+
+  /// Receive the lists from [nativeUpdateDeltas].
+  final Pointer<Pointer<Float>> _born = malloc<Pointer<Float>>();
+  final Pointer<Pointer<Float>> _died = malloc<Pointer<Float>>();
+  final Pointer<Int64> _diedCount = malloc<Int64>();
+
+  /// Receives the phase timings from [nativeGetStats].
+  final Pointer<NativeGolStats> _stats = malloc<NativeGolStats>();
+
+  /// Creates the native engine. With [cells] it starts from that grid,
+  /// converted natively in one pass, instead of its own random soup.
+  CppComputer(int rows, int cols, double cellSize, {InputGrid? cells}) {
     setupNativeLibrary();
     // nativeLib = DynamicLibrary.process();
 
     nativeInit = nativeLib.lookupFunction<_nativeInit, _dartInit>("initCpp");
+    nativeInitFrom = nativeLib
+        .lookupFunction<_nativeInitFrom, _dartInitFrom>("initCppFrom");
     nativeUpdate =
         nativeLib.lookupFunction<_nativeUpdate, _dartUpdate>("updateCpp");
+    nativeUpdateCounted = nativeLib
+        .lookupFunction<_nativeUpdateCounted, _dartUpdateCounted>(
+            "updateCountedCpp");
+    nativeUpdateDeltas = nativeLib
+        .lookupFunction<_nativeUpdateDeltas, _dartUpdateDeltas>(
+            "updateDeltasCpp");
+    nativeAliveCount = nativeLib
+        .lookupFunction<_nativeAliveCount, _dartAliveCount>("aliveCountCpp");
+    nativeGetStats = nativeLib
+        .lookupFunction<_nativeGetStats, _dartGetStats>("getStatsCpp");
+    nativeResetStats = nativeLib
+        .lookupFunction<_nativeResetStats, _dartResetStats>("resetStatsCpp");
+    nativeStep = nativeLib.lookupFunction<_nativeStep, _dartStep>("stepCpp");
+    nativeCollect = nativeLib
+        .lookupFunction<_nativeCollect, _dartCollect>("collectAliveCpp");
+    nativeApplyEdits =
+        nativeLib.lookupFunction<_nativeApplyEdits, _dartApplyEdits>(
+            "applyEditsCpp");
+    nativeSetViewport =
+        nativeLib.lookupFunction<_nativeSetViewport, _dartSetViewport>(
+            "setViewportCpp");
+    nativeSetLod =
+        nativeLib.lookupFunction<_nativeSetLod, _dartSetLod>("setLodCpp");
+    nativeSetPointFormat = nativeLib
+        .lookupFunction<_nativeSetPointFormat, _dartSetPointFormat>(
+            "setPointFormatCpp");
+    nativeRender =
+        nativeLib.lookupFunction<_nativeRender, _dartRender>("renderCpp");
+    nativeStartAsync = nativeLib
+        .lookupFunction<_nativeSetRate, _dartSetRate>("startAsyncCpp");
+    nativeSetTargetRate = nativeLib
+        .lookupFunction<_nativeSetRate, _dartSetRate>("setTargetRateCpp");
+    nativeLatestFrame = nativeLib
+        .lookupFunction<_nativeLatestFrame, _dartLatestFrame>(
+            "latestFrameCpp");
+    nativeStopAsync = nativeLib
+        .lookupFunction<_nativeDestruct, _dartDestruct>("stopAsyncCpp");
     nativeDestruct =
         nativeLib.lookupFunction<_nativeDestruct, _dartDestruct>("destructCpp");
 
     //init cpp class
-    nativeInit(rows, cols, cellSize);
+    if (cells != null) {
+      nativeInitFrom(rows, cols, cellSize, cells.dataPointer.cast<Void>(),
+          _cellFormatFloats);
+    } else {
+      nativeInit(rows, cols, cellSize);
+    }
   }
 
   void setupNativeLibrary() {
@@ -43,11 +223,153 @@ class CppComputer {
     }
   }
 
+  /// Hands the newest generation to [data]. While [startAsync] is in effect
+  /// this only picks up the latest frame of the native thread and never
+  /// waits for a generation.
   void updateCpp(GolData data) {
-    data.outputGrid.dataPointer = nativeUpdate();
+    if (_async) {
+      data.outputGrid.dataPointer =
+          nativeLatestFrame(_count, _pointFloats, _frameLod, nullptr);
+      data.outputGrid.pointCount = _count.value;
+      data.outputGrid.lodLevel = _frameLod.value;
+      data.outputGrid.packedCells = _pointFloats.value == 1;
+      return;
+    }
+    data.outputGrid.dataPointer = nativeUpdateCounted(_count);
+    data.outputGrid.pointCount = _count.value;
+    data.outputGrid.lodLevel = _lod;
+    data.outputGrid.packedCells = _packed;
+  }
+
+  /// Advances one generation and returns only the cells that changed in
+  /// the viewport, for renderers that keep the previous frame. The output
+  /// of [updateCpp] is not rebuilt; [collect] gives a full frame again.
+  /// Must not be used while [startAsync] is in effect.
+  CellDeltas updateDeltas() {
+    nativeUpdateDeltas(_born, _count, _died, _diedCount);
+    return CellDeltas(_born.value.asTypedList(_count.value * 2),
+        _died.value.asTypedList(_diedCount.value * 2));
+  }
+
+  /// Advances [generations] generations without rebuilding the output.
+  void step(int generations) {
+    nativeStep(generations);
+  }
+
+  /// Rebuilds the output from the current generation.
+  void collect(GolData data) {
+    data.outputGrid.dataPointer = nativeCollect();
+    data.outputGrid.pointCount = nativeAliveCount();
+    data.outputGrid.lodLevel = _lod;
+    data.outputGrid.packedCells = _packed;
+  }
+
+  /// Sets or toggles cells between generations, e.g. for drawing with a
+  /// pen. [xy] holds x, y pairs and [states] one entry per pair: 0 = dead,
+  /// 1 = alive, 2 = toggle. Cells outside the grid are ignored. Must not be
+  /// used while [startAsync] is in effect.
+  void applyEdits(List<int> xy, List<int> states) {
+    final n = states.length;
+    final nativeXy = malloc<Int32>(n * 2);
+    final nativeStates = malloc<Uint8>(n);
+    nativeXy.asTypedList(n * 2).setAll(0, xy);
+    nativeStates.asTypedList(n).setAll(0, states);
+    nativeApplyEdits(nativeXy, nativeStates, n);
+    malloc.free(nativeXy);
+    malloc.free(nativeStates);
+  }
+
+  /// Limits the output to the cells in [x0, x1) x [y0, y1), e.g. the part
+  /// of the grid on screen; everything is still simulated. Ignored while
+  /// [startAsync] is in effect, when the native thread owns the engine.
+  void setViewport(int x0, int y0, int x1, int y1) {
+    if (!_async) {
+      nativeSetViewport(x0, y0, x1, y1);
+    }
+  }
+
+  /// Switches the output to one weighted point per live 2^[level] x
+  /// 2^[level] block (level 1 to 6) for zoomed-out views, or back to one
+  /// point per live cell with 0. Ignored while [startAsync] is in effect.
+  void setLod(int level) {
+    if (!_async) {
+      nativeSetLod(level);
+      _lod = level.clamp(0, OutputGrid.maxLodLevel);
+    }
+  }
+
+  /// Switches the per-cell output to packed cell coordinates, one 32-bit
+  /// x | y << 16 word per live cell, or back to "x, y" centres, see
+  /// [OutputGrid.packedCells]. Returns whether the output is now packed;
+  /// grids over 65536 cells a side cannot be. Ignored while [startAsync]
+  /// is in effect.
+  bool setPackedOutput(bool packed) {
+    if (_async) {
+      return _packed;
+    }
+    final format = packed ? _pointFormatCells : _pointFormatFloats;
+    if (nativeSetPointFormat(format) == 0) {
+      _packed = packed;
+    }
+    return _packed;
+  }
+
+  /// Advances one generation and draws it into [buffer] instead of listing
+  /// its live cells. A cell spans [cellPixels] scene units and scene point
+  /// s lands on pixel s * [zoom] + ([offsetX], [offsetY]), as on a canvas
+  /// scaled and then translated. Colours are `Color.value`s. Must not be
+  /// used while [startAsync] is in effect.
+  void render(PixelBuffer buffer,
+      {required double cellPixels,
+      double zoom = 1,
+      double offsetX = 0,
+      double offsetY = 0,
+      int aliveColor = 0xFF000000,
+      int deadColor = 0x00000000}) {
+    nativeStep(1);
+    nativeRender(buffer.pointer, buffer.width, buffer.height,
+        _pixelFormatRgba8, cellPixels, zoom, offsetX, offsetY, aliveColor,
+        deadColor);
+  }
+
+  /// Steps the grid on a native thread at [gensPerSecond] (0 for as fast as
+  /// possible), off the UI isolate. Calling it again changes the rate.
+  /// [step] and [collect] must not be used until [stopAsync].
+  void startAsync(double gensPerSecond) {
+    if (_async) {
+      nativeSetTargetRate(gensPerSecond);
+    } else {
+      nativeStartAsync(gensPerSecond);
+      _async = true;
+    }
+  }
+
+  /// Stops the native thread once it finishes its current generation.
+  void stopAsync() {
+    nativeStopAsync();
+    _async = false;
+  }
+
+  /// Returns the phase timings since the previous call and starts a new
+  /// measurement window, or null while [startAsync] is in effect, when the
+  /// native thread owns them.
+  PhaseTimes? takeStats() {
+    if (_async) {
+      return null;
+    }
+    nativeGetStats(_stats);
+    nativeResetStats();
+    return PhaseTimes.fromNative(_stats.ref);
   }
 
   void dispose() {
     nativeDestruct();
+    malloc.free(_count);
+    malloc.free(_pointFloats);
+    malloc.free(_frameLod);
+    malloc.free(_born);
+    malloc.free(_died);
+    malloc.free(_diedCount);
+    malloc.free(_stats);
   }
 }
@@ -6,7 +6,12 @@ import 'package:game_of_life/computers/dart/dart_computer.dart';
 import 'package:game_of_life/computers/go/golang_computer.dart';
 import 'package:game_of_life/computers/go/golang_threads_computer.dart';
 import 'package:game_of_life/computers/metal/metal_computer.dart';
+import 'package:game_of_life/data/cell_deltas.dart';
 import 'package:game_of_life/data/gol_data.dart';
+import 'package:game_of_life/data/gol_stats.dart';
+import 'package:game_of_life/data/input_grid.dart';
+import 'package:game_of_life/data/output_grid.dart';
+import 'package:game_of_life/data/pixel_buffer.dart';
 import 'package:game_of_life/data/update_type.dart';
 
 /// A factory and coordinator class for Game of Life computations.
@@ -45,7 +50,12 @@ class GolComputer {
 
   /// Base interface for all computation backends.
   /// Only one of these will be non-null based on the selected update type.
-  late final _ComputerBackend _activeBackend;
+  /// Created by [initData], so native engines can start from its input
+  /// grid, or on first use if that is never called.
+  _ComputerBackend? _backend;
+
+  _ComputerBackend get _activeBackend =>
+      _backend ??= _createBackend(updateType, null);
 
   /// Platform detection flags for determining available backends.
   static final bool _isMacOS = Platform.isMacOS;
@@ -79,9 +89,6 @@ class GolComputer {
 
     // Determine the actual update type based on platform support
     updateType = _selectSupportedUpdateType(requestedType);
-
-    // Initialize the appropriate backend
-    _activeBackend = _createBackend(updateType);
   }
 
   /// Determines if a given update type is supported on the current platform.
@@ -113,14 +120,18 @@ class GolComputer {
   }
 
   /// Creates the appropriate backend instance based on update type.
-  _ComputerBackend _createBackend(UpdateType type) {
+  ///
+  /// The C++ engines start from [cells] when given, instead of seeding a
+  /// random soup of their own.
+  _ComputerBackend _createBackend(UpdateType type, InputGrid? cells) {
     switch (type) {
       case UpdateType.flutter:
         return _DartBackend(DartComputer(rows, columns, cellSize));
       case UpdateType.cpp:
-        return _CppBackend(CppComputer(rows, columns, cellSize));
+        return _CppBackend(CppComputer(rows, columns, cellSize, cells: cells));
       case UpdateType.cppThreads:
-        return _CppThreadsBackend(CppThreadsComputer(rows, columns, cellSize));
+        return _CppThreadsBackend(
+            CppThreadsComputer(rows, columns, cellSize, cells: cells));
       case UpdateType.metal:
         return _MetalBackend(MetalComputer(rows, columns, cellSize));
       case UpdateType.golang:
@@ -135,7 +146,9 @@ class GolComputer {
   ///
   /// Returns a [GolData] object configured with the grid dimensions and update type.
   GolData initData() {
-    return GolData(rows, columns, updateType);
+    final data = GolData(rows, columns, updateType);
+    _backend ??= _createBackend(updateType, data.inputGrid);
+    return data;
   }
 
   /// Updates the Game of Life state using the active backend.
@@ -148,12 +161,73 @@ class GolComputer {
     _activeBackend.update(golData);
   }
 
+  /// Moves stepping onto a native background thread running at
+  /// [gensPerSecond] generations per second (0 for as fast as possible), so
+  /// [update] only picks up the newest finished generation and never stalls
+  /// the UI. Calling it again changes the rate.
+  ///
+  /// Returns false, and leaves stepping on [update], for backends without a
+  /// native simulation thread.
+  bool startAsync({double gensPerSecond = 0}) {
+    return _activeBackend.startAsync(gensPerSecond);
+  }
+
+  /// Limits the output to the cells in [x0, x1) x [y0, y1), typically the
+  /// visible part of the grid. Backends that cannot cull keep emitting
+  /// every live cell.
+  void setViewport(int x0, int y0, int x1, int y1) {
+    _activeBackend.setViewport(x0, y0, x1, y1);
+  }
+
+  /// Switches the output to one weighted point per live 2^[level] x
+  /// 2^[level] block, or back to one point per live cell with 0, see
+  /// [OutputGrid.lodLevel]. Backends without density output ignore it and
+  /// keep reporting level 0.
+  void setLod(int level) {
+    _activeBackend.setLod(level);
+  }
+
+  /// Switches the per-cell output to packed cell coordinates, see
+  /// [OutputGrid.packedCells], or back to "x, y" centres. Returns whether
+  /// the output is now packed; backends without packed output keep floats.
+  bool setPackedOutput(bool packed) {
+    return _activeBackend.setPackedOutput(packed);
+  }
+
+  /// Advances one generation and returns only the cells that were born or
+  /// died, instead of updating the point list of [update]. Returns null,
+  /// without stepping, for backends that do not track changes.
+  CellDeltas? updateDeltas() {
+    return _activeBackend.updateDeltas();
+  }
+
+  /// Advances one generation and draws it into [buffer] rather than into
+  /// the point list of [update]; see `CppComputer.render` for the
+  /// transform. Returns false, without stepping, for backends that cannot
+  /// draw natively.
+  bool render(PixelBuffer buffer,
+      {required double cellPixels,
+      double zoom = 1,
+      double offsetX = 0,
+      double offsetY = 0,
+      int aliveColor = 0xFF000000,
+      int deadColor = 0x00000000}) {
+    return _activeBackend.render(buffer, cellPixels, zoom, offsetX, offsetY,
+        aliveColor, deadColor);
+  }
+
+  /// Returns the native engine's per-phase timings since the previous call,
+  /// or null for backends that do not record them.
+  PhaseTimes? takeStats() {
+    return _activeBackend.takeStats();
+  }
+
   /// Disposes of resources used by the active backend.
   ///
   /// This method should be called when the computer is no longer needed
   /// to free native resources (if any). It's safe to call multiple times.
   void dispose() {
-    _activeBackend.dispose();
+    _backend?.dispose();
   }
 
   /// Returns a list of all supported update types on the current platform.
@@ -180,17 +254,36 @@ class GolComputer {
   }
 }
 
-/// Base interface for computation backends.
+/// Base class for computation backends.
 ///
 /// This provides a common interface for all backend implementations,
-/// allowing for cleaner polymorphic handling.
+/// allowing for cleaner polymorphic handling. Only [update] and [dispose]
+/// must be implemented; the optional features default to "not supported"
+/// and are overridden by the backends that have them.
 abstract class _ComputerBackend {
   void update(GolData golData);
+
+  bool startAsync(double gensPerSecond) => false;
+
+  void setViewport(int x0, int y0, int x1, int y1) {}
+
+  void setLod(int level) {}
+
+  bool setPackedOutput(bool packed) => false;
+
+  CellDeltas? updateDeltas() => null;
+
+  bool render(PixelBuffer buffer, double cellPixels, double zoom,
+          double offsetX, double offsetY, int aliveColor, int deadColor) =>
+      false;
+
+  PhaseTimes? takeStats() => null;
+
   void dispose();
 }
 
 /// Dart backend wrapper.
-class _DartBackend implements _ComputerBackend {
+class _DartBackend extends _ComputerBackend {
   final DartComputer _computer;
 
   _DartBackend(this._computer);
@@ -205,7 +298,7 @@ class _DartBackend implements _ComputerBackend {
 }
 
 /// C++ backend wrapper.
-class _CppBackend implements _ComputerBackend {
+class _CppBackend extends _ComputerBackend {
   final CppComputer _computer;
 
   _CppBackend(this._computer);
@@ -213,12 +306,47 @@ class _CppBackend implements _ComputerBackend {
   @override
   void update(GolData golData) => _computer.updateCpp(golData);
 
+  @override
+  bool startAsync(double gensPerSecond) {
+    _computer.startAsync(gensPerSecond);
+    return true;
+  }
+
+  @override
+  void setViewport(int x0, int y0, int x1, int y1) =>
+      _computer.setViewport(x0, y0, x1, y1);
+
+  @override
+  void setLod(int level) => _computer.setLod(level);
+
+  @override
+  bool setPackedOutput(bool packed) => _computer.setPackedOutput(packed);
+
+  @override
+  CellDeltas? updateDeltas() => _computer.updateDeltas();
+
+  @override
+  bool render(PixelBuffer buffer, double cellPixels, double zoom,
+      double offsetX, double offsetY, int aliveColor, int deadColor) {
+    _computer.render(buffer,
+        cellPixels: cellPixels,
+        zoom: zoom,
+        offsetX: offsetX,
+        offsetY: offsetY,
+        aliveColor: aliveColor,
+        deadColor: deadColor);
+    return true;
+  }
+
+  @override
+  PhaseTimes? takeStats() => _computer.takeStats();
+
   @override
   void dispose() => _computer.dispose();
 }
 
 /// C++ Threads backend wrapper.
-class _CppThreadsBackend implements _ComputerBackend {
+class _CppThreadsBackend extends _ComputerBackend {
   final CppThreadsComputer _computer;
 
   _CppThreadsBackend(this._computer);
@@ -226,12 +354,47 @@ class _CppThreadsBackend implements _ComputerBackend {
   @override
   void update(GolData golData) => _computer.updateCpp(golData);
 
+  @override
+  bool startAsync(double gensPerSecond) {
+    _computer.startAsync(gensPerSecond);
+    return true;
+  }
+
+  @override
+  void setViewport(int x0, int y0, int x1, int y1) =>
+      _computer.setViewport(x0, y0, x1, y1);
+
+  @override
+  void setLod(int level) => _computer.setLod(level);
+
+  @override
+  bool setPackedOutput(bool packed) => _computer.setPackedOutput(packed);
+
+  @override
+  CellDeltas? updateDeltas() => _computer.updateDeltas();
+
+  @override
+  bool render(PixelBuffer buffer, double cellPixels, double zoom,
+      double offsetX, double offsetY, int aliveColor, int deadColor) {
+    _computer.render(buffer,
+        cellPixels: cellPixels,
+        zoom: zoom,
+        offsetX: offsetX,
+        offsetY: offsetY,
+        aliveColor: aliveColor,
+        deadColor: deadColor);
+    return true;
+  }
+
+  @override
+  PhaseTimes? takeStats() => _computer.takeStats();
+
   @override
   void dispose() => _computer.dispose();
 }
 
 /// Metal backend wrapper.
-class _MetalBackend implements _ComputerBackend {
+class _MetalBackend extends _ComputerBackend {
   final MetalComputer _computer;
 
   _MetalBackend(this._computer);
@@ -244,7 +407,7 @@ class _MetalBackend implements _ComputerBackend {
 }
 
 /// Go backend wrapper.
-class _GoLangBackend implements _ComputerBackend {
+class _GoLangBackend extends _ComputerBackend {
   final GoLangComputer _computer;
 
   _GoLangBackend(this._computer);
@@ -257,7 +420,7 @@ class _GoLangBackend implements _ComputerBackend {
 }
 
 /// Go Threads backend wrapper.
-class _GoLangThreadsBackend implements _ComputerBackend {
+class _GoLangThreadsBackend extends _ComputerBackend {
   final GoLangThreadsComputer _computer;
 
   _GoLangThreadsBackend(this._computer);
@@ -0,0 +1,16 @@
+import 'dart:typed_data';
+
+import 'package:game_of_life/data/output_grid.dart';
+
+/// The cells that changed in one generation, as "x, y" centre points laid
+/// out like the [OutputGrid] points. Both lists are views of native
+/// buffers, valid until the next update.
+class CellDeltas {
+  /// Cells that came alive.
+  final Float32List born;
+
+  /// Cells that died.
+  final Float32List died;
+
+  const CellDeltas(this.born, this.died);
+}
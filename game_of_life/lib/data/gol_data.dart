@@ -1,3 +1,5 @@
+import 'dart:ui';
+
 import 'package:game_of_life/data/input_grid.dart';
 import 'package:game_of_life/data/output_grid.dart';
 import 'package:game_of_life/data/update_type.dart';
@@ -12,6 +14,13 @@ class GolData {
   late InputGrid inputGrid;
   late OutputGrid outputGrid;
 
+  /// Part of the grid the painter last showed, in output coordinates
+  /// (cellSize per cell). Null until the first paint.
+  Rect? visibleRect;
+
+  /// On-screen size of one cell, in logical pixels, at the last paint.
+  double cellExtent = 0;
+
   GolData(this.rows, this.columns, this.updateType) {
     inputGrid = InputGrid(rows, columns, updateType, initRandom: true);
     outputGrid = OutputGrid(rows, columns, updateType);
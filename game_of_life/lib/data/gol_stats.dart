@@ -0,0 +1,65 @@
+import 'dart:ffi';
+
+/// Mirror of the native `GolStats` struct in `lib/libs/cppStats.hpp`.
+///
+/// All times are nanoseconds accumulated since the last reset.
+final class NativeGolStats extends Struct {
+  @Uint64()
+  external int frames;
+
+  @Uint64()
+  external int totalNs;
+
+  @Uint64()
+  external int clearNs;
+
+  @Uint64()
+  external int borderNs;
+
+  @Uint64()
+  external int stepNs;
+
+  @Uint64()
+  external int collectNs;
+
+  @Uint64()
+  external int syncNs;
+
+  @Uint64()
+  external int mergeNs;
+}
+
+/// Average time per frame spent in each phase of a native engine, in
+/// microseconds.
+class PhaseTimes {
+  final int frames;
+  final double total;
+  final double clear;
+  final double border;
+  final double step;
+  final double collect;
+  final double sync;
+  final double merge;
+
+  PhaseTimes.fromNative(NativeGolStats stats)
+      : frames = stats.frames,
+        total = _perFrame(stats.totalNs, stats.frames),
+        clear = _perFrame(stats.clearNs, stats.frames),
+        border = _perFrame(stats.borderNs, stats.frames),
+        step = _perFrame(stats.stepNs, stats.frames),
+        collect = _perFrame(stats.collectNs, stats.frames),
+        sync = _perFrame(stats.syncNs, stats.frames),
+        merge = _perFrame(stats.mergeNs, stats.frames);
+
+  static double _perFrame(int ns, int frames) =>
+      frames == 0 ? 0 : ns / frames / 1000.0;
+
+  /// One line summary for overlays, e.g. `step 120 · collect 40 ... µs`.
+  @override
+  String toString() {
+    String f(double us) => us.toStringAsFixed(0);
+    return 'step ${f(step)} · collect ${f(collect)} · border ${f(border)}'
+        ' · clear ${f(clear)} · sync ${f(sync)} · merge ${f(merge)}'
+        ' · total ${f(total)} µs';
+  }
+}
@@ -174,10 +174,7 @@ class InputGrid {
       dataFloatList.fillRange(0, dataFloatList.length, 0.0);
     } else {
       // For FFI implementations
-      final totalElements = rows * columns;
-      for (int i = 0; i < totalElements; i++) {
-        dataPointer[i] = 0.0;
-      }
+      toFloat32List().fillRange(0, totalElements, 0.0);
     }
   }
 
@@ -192,8 +189,11 @@ class InputGrid {
       throw StateError('Cannot initialize a disposed grid');
     }
 
-    for (int i = 0; i < rows * columns; i++) {
-      this[i] = random.nextBool() ? 1.0 : 0.0;
+    // Write through a typed view rather than [] per cell, which goes
+    // through the disposed check and a pointer offset every time
+    final cells = data;
+    for (int i = 0; i < cells.length; i++) {
+      cells[i] = random.nextBool() ? 1.0 : 0.0;
     }
   }
 
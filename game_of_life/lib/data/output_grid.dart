@@ -6,9 +6,10 @@ import 'package:game_of_life/data/update_type.dart';
 /// An output grid data structure that supports both Flutter-native and FFI implementations.
 ///
 /// This class is designed to store rendering output data for a 2D grid, typically used for
-/// visualization purposes. Each grid cell stores two float values, making the total size
-/// `rows * columns * 2`. This dual-value structure is commonly used for storing
-/// position coordinates, color components, or other paired data.
+/// visualization purposes. The Flutter list, and the native buffers of the Go and Metal
+/// implementations, hold two float values per grid cell, `rows * columns * 2` in total.
+/// The C++ implementations size their buffers by the population instead and report it
+/// in [pointCount]; only that many points may be read from them.
 ///
 /// Example usage:
 /// ```dart
@@ -42,10 +43,48 @@ class OutputGrid {
   late Float32List dataFloatList;
 
   /// Pointer to native memory for FFI implementations.
-  /// Points to memory containing `rows * columns * 2` float values.
+  /// Go and Metal point it at `rows * columns * 2` float values; the C++
+  /// implementations at a buffer that only holds [pointCount] points of
+  /// [pointFloats] words, plus a terminator.
   /// Used for all non-Flutter update types (cpp, cppThreads, metal, golang, golangThreads).
   late Pointer<Float> dataPointer;
 
+  /// Number of points at the start of [dataPointer] that hold live cells.
+  ///
+  /// Set by FFI implementations that report their population; the rest of
+  /// the native buffer is then ignored. A negative value means unknown, in
+  /// which case all `rows * columns` points are used, which only the
+  /// full-grid buffers of Go and Metal hold.
+  int pointCount = -1;
+
+  /// Highest density level an FFI implementation may report in [lodLevel].
+  static const int maxLodLevel = 6;
+
+  /// Density level of the native buffer. 0 means one "x, y" point per live
+  /// cell; level L means one "x, y, weight" point per live 2^L x 2^L block,
+  /// centred on the block, with its live fraction as the weight.
+  int lodLevel = 0;
+
+  /// Whether an FFI implementation wrote packed cells instead of "x, y"
+  /// centres: one 32-bit word per live cell with the column in the low and
+  /// the row in the high 16 bits, read through [cells]. Only used at
+  /// [lodLevel] 0.
+  bool packedCells = false;
+
+  /// 32-bit words per point in the native buffer, see [lodLevel] and
+  /// [packedCells].
+  int get pointFloats => lodLevel > 0 ? 3 : (packedCells ? 1 : 2);
+
+  /// The packed cells as (column, row) pairs, `pointCount * 2` entries,
+  /// viewing the native memory without copying. Only meaningful while
+  /// [packedCells] is set.
+  Uint16List get cells {
+    if (_isDisposed) {
+      throw StateError('Cannot access data of a disposed output grid');
+    }
+    return dataPointer.cast<Uint16>().asTypedList(pointCount * 2);
+  }
+
   /// Finalizer to automatically clean up native memory when the object is garbage collected.
   /// This provides a safety net in case [dispose] is not called manually.
   final Finalizer<Pointer<Float>> _finalizer;
@@ -63,12 +102,39 @@ class OutputGrid {
   /// All update types except Flutter use FFI and require native memory management.
   bool get _isFFIBased => updateType != UpdateType.flutter;
 
+  /// Returns true if the native buffer holds a point for every grid cell.
+  ///
+  /// Only Go and Metal allocate their output per cell; the C++ buffers
+  /// grow with the population and end right after [pointCount] points.
+  bool get _hasFullGridBuffer =>
+      updateType == UpdateType.metal ||
+      updateType == UpdateType.golang ||
+      updateType == UpdateType.golangThreads;
+
+  /// Number of floats at [dataPointer] that may be read or written:
+  /// `pointCount * pointFloats` when the population is known, otherwise
+  /// the whole grid for full-grid buffers.
+  ///
+  /// Throws [StateError] for a population-sized buffer whose [pointCount]
+  /// has not been set.
+  int get _nativeLength {
+    if (pointCount >= 0) {
+      return pointCount * pointFloats;
+    }
+    if (_hasFullGridBuffer) {
+      return rows * columns * 2;
+    }
+    throw StateError(
+        'Point count not set for a population-sized native buffer');
+  }
+
   /// Returns the output grid data as a [Float32List].
   ///
   /// For Flutter implementation, returns the internal [dataFloatList].
   /// For FFI implementations, converts the native pointer to a typed list.
   ///
-  /// The returned list has size `rows * columns * 2`.
+  /// The returned list has size `rows * columns * 2` for the Flutter, Go and
+  /// Metal implementations, and `pointCount * pointFloats` for C++.
   Float32List get data {
     if (updateType == UpdateType.flutter) {
       return dataFloatList;
@@ -79,7 +145,8 @@ class OutputGrid {
   /// Accesses an output grid element by linear index.
   ///
   /// Since each cell stores two values, the total accessible indices range from
-  /// 0 to `(rows * columns * 2) - 1`.
+  /// 0 to `(rows * columns * 2) - 1`, or to `pointCount * pointFloats - 1`
+  /// for the population-sized C++ buffers.
   ///
   /// Parameters:
   /// - [idx]: The linear index of the element to access.
@@ -102,7 +169,8 @@ class OutputGrid {
   /// Sets an output grid element by linear index.
   ///
   /// Since each cell stores two values, the total accessible indices range from
-  /// 0 to `(rows * columns * 2) - 1`.
+  /// 0 to `(rows * columns * 2) - 1`, or to `pointCount * pointFloats - 1`
+  /// for the population-sized C++ buffers.
   ///
   /// Parameters:
   /// - [idx]: The linear index of the element to set.
@@ -165,7 +233,8 @@ class OutputGrid {
   /// that contains the output data.
   ///
   /// Parameters:
-  /// - [pointer]: Pointer to external memory containing `rows * columns * 2` float values.
+  /// - [pointer]: Pointer to external memory containing `rows * columns * 2` float values
+  ///   (Go and Metal), or [pointCount] points of [pointFloats] words (C++).
   /// - [shouldManageMemory]: Whether this class should manage the memory lifecycle.
   ///   If true, the memory will be freed when [dispose] is called.
   ///   If false, the external code is responsible for memory management.
@@ -199,9 +268,12 @@ class OutputGrid {
   /// It creates a view of the native memory without copying the data.
   ///
   /// Returns a [Float32List] that directly maps to the native memory
-  /// with size `rows * columns * 2`.
+  /// with size `pointCount * pointFloats`, or `rows * columns * 2` when
+  /// [pointCount] is unknown and the buffer is a full-grid one (Go and
+  /// Metal).
   ///
-  /// Throws [StateError] if called on a disposed grid or Flutter implementation.
+  /// Throws [StateError] if called on a disposed grid or Flutter implementation,
+  /// or on a population-sized buffer before [pointCount] is set.
   Float32List toFloat32List() {
     if (updateType == UpdateType.flutter) {
       throw StateError(
@@ -214,16 +286,18 @@ class OutputGrid {
       throw StateError('Data pointer not set. Call setDataPointer() first.');
     }
 
-    return dataPointer.asTypedList(rows * columns * 2);
+    return dataPointer.asTypedList(_nativeLength);
   }
 
   /// Clears the output grid by setting all elements to 0.0.
   ///
   /// This method works for both Flutter and FFI implementations.
   /// For Flutter implementation, uses the efficient [fillRange] method.
-  /// For FFI implementations, iterates through all elements.
+  /// For FFI implementations, iterates through the elements the native
+  /// buffer holds, see [toFloat32List].
   ///
-  /// Throws [StateError] if called on a disposed grid.
+  /// Throws [StateError] if called on a disposed grid, or on a
+  /// population-sized buffer before [pointCount] is set.
   void clear() {
     if (_isDisposed) {
       throw StateError('Cannot clear a disposed output grid');
@@ -238,8 +312,8 @@ class OutputGrid {
         throw StateError('Data pointer not set. Call setDataPointer() first.');
       }
 
-      final totalElements = rows * columns * 2;
-      for (int i = 0; i < totalElements; i++) {
+      final length = _nativeLength;
+      for (int i = 0; i < length; i++) {
         dataPointer[i] = 0.0;
       }
     }
@@ -273,9 +347,11 @@ class OutputGrid {
     _isDisposed = true;
   }
 
-  /// Returns the total number of elements in the output grid.
+  /// Returns the number of elements a full output grid holds.
   ///
-  /// Since each cell stores two values, this returns `rows * columns * 2`.
+  /// Since each cell stores two values, this returns `rows * columns * 2`:
+  /// the size of the Flutter list and of the Go and Metal buffers. The C++
+  /// buffers only hold `pointCount * pointFloats`.
   int get totalElements => rows * columns * 2;
 
   /// Returns whether this output grid has been disposed.
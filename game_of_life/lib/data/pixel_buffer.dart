@@ -0,0 +1,27 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+/// A native RGBA8 buffer the C++ engines draw whole generations into (see
+/// `GolComputer.render`), so a frame is one image instead of a point per
+/// live cell.
+class PixelBuffer {
+  /// Size in pixels.
+  final int width;
+  final int height;
+
+  /// Native memory of `width * height * 4` bytes, R G B A per pixel.
+  final Pointer<Uint8> pointer;
+
+  PixelBuffer(this.width, this.height)
+      : pointer = malloc<Uint8>(width * height * 4);
+
+  /// The pixels, ready for `ui.decodeImageFromPixels` with
+  /// `PixelFormat.rgba8888`. A view of native memory, valid until [dispose].
+  Uint8List get pixels => pointer.asTypedList(width * height * 4);
+
+  void dispose() {
+    malloc.free(pointer);
+  }
+}
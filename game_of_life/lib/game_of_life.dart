@@ -1,5 +1,6 @@
 import 'package:game_of_life/data/gol_data.dart';
 import 'package:game_of_life/computers/gol_computer.dart';
+import 'package:game_of_life/data/output_grid.dart';
 import 'package:game_of_life/data/update_type.dart';
 
 class GameOfLife {
@@ -18,9 +19,41 @@ class GameOfLife {
   }
 
   void updateGrid() {    
+      _cullToVisible();
+      _pickLod();
       golComputer.update(golData);
     
   }
+
+  /// Restricts the engine's output to the cells the painter showed last,
+  /// plus one cell of margin, so zoomed-in frames only carry those.
+  void _cullToVisible() {
+    final visible = golData.visibleRect;
+    if (visible == null) {
+      return;
+    }
+    const cellSize = GolData.cellSize;
+    golComputer.setViewport(
+        (visible.left / cellSize).floor() - 1,
+        (visible.top / cellSize).floor() - 1,
+        (visible.right / cellSize).ceil() + 1,
+        (visible.bottom / cellSize).ceil() + 1);
+  }
+
+  /// Lets the engine sum cells into blocks once a cell is smaller than a
+  /// pixel: the smallest level whose blocks cover at least one pixel.
+  void _pickLod() {
+    final extent = golData.cellExtent;
+    if (extent <= 0) {
+      return;
+    }
+    int level = 0;
+    while (level < OutputGrid.maxLodLevel && extent * (1 << level) < 1) {
+      level++;
+    }
+    golComputer.setLod(level);
+  }
+
   void dispose(){
     golComputer.dispose();
   }
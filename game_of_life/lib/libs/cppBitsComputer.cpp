@@ -0,0 +1,320 @@
+#include "cppBitsComputer.hpp"
+#include "cppBoundary.hpp"
+#include "cppSeed.hpp"
+#include "cppViewport.hpp"
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
+
+CppBitsComputer::CppBitsComputer(int32_t nRows, int32_t nCols, double cellSize, const void* cells, int format)
+: rows(nRows), cols(nCols), cellSize(cellSize)
+{
+    wordsPerRow = (cols + 63) / 64;
+    if (cols % 64 != 0) {
+        lastWordMask = (1ull << (cols % 64)) - 1;
+    }
+    m_view = golFullViewport(rows, cols);
+    initData(cells, format);
+}
+
+CppBitsComputer::~CppBitsComputer()
+{
+    delete[] m_pWords;
+    delete[] m_pNewWords;
+    delete[] m_pGhostTop;
+    delete[] m_pGhostBottom;
+    delete[] m_pAliveLocs;
+}
+
+// Starts from cells when given, see load, and from the legacy soup
+// otherwise.
+void CppBitsComputer::initData(const void* cells, int format)
+{
+    m_pWords = new uint64_t[(int64_t)rows * wordsPerRow]();
+    m_pNewWords = new uint64_t[(int64_t)rows * wordsPerRow]();
+    m_pGhostTop = new uint64_t[wordsPerRow]();
+    m_pGhostBottom = new uint64_t[wordsPerRow]();
+    if (cells) {
+        load(cells, format);
+    } else {
+        populateWithBools();
+    }
+}
+
+void CppBitsComputer::populateWithBools()
+{
+    // Same sequence as CppComputer so both engines start from the same soup
+    srand(7);
+    for (int y = 0; y < rows; ++y)
+    {
+        uint64_t* row = m_pWords + y * wordsPerRow;
+        for (int x = 0; x < cols; ++x)
+        {
+            if (rand() % 2) {
+                row[x >> 6] |= 1ull << (x & 63);
+            }
+        }
+    }
+}
+
+// Replaces the grid with a soup of the given density, see golSeedSoup.
+void CppBitsComputer::seed(uint32_t seed, double density)
+{
+    uint8_t* cells = new uint8_t[(int64_t)rows * cols];
+    golSeedSoup(cells, rows, cols, cols, seed, density);
+    load(cells);
+    delete[] cells;
+}
+
+// Replaces the grid with cells, rows * cols cells in the given
+// GolCellFormat. Each row goes through a small byte buffer
+// on its way to being packed.
+void CppBitsComputer::load(const void* cells, int format)
+{
+    memset(m_pWords, 0, (int64_t)rows * wordsPerRow * sizeof(uint64_t));
+    uint8_t* rowCells = new uint8_t[cols];
+    for (int y = 0; y < rows; y++) {
+        golImportRow(rowCells, cells, format, cols, y);
+        uint64_t* row = m_pWords + y * wordsPerRow;
+        for (int x = 0; x < cols; x++) {
+            row[x >> 6] |= (uint64_t)rowCells[x] << (x & 63);
+        }
+    }
+    delete[] rowCells;
+}
+
+// Applies n edits between generations: cell (xy[2i], xy[2i+1]) takes
+// GolEdit states[i]. Cells outside the grid are ignored. The output buffer
+// is not touched until the next update or collect.
+void CppBitsComputer::applyEdits(const int32_t* xy, const uint8_t* states, int n)
+{
+    for (int i = 0; i < n; i++) {
+        const int x = xy[2 * i];
+        const int y = xy[2 * i + 1];
+        if (x < 0 || y < 0 || x >= cols || y >= rows) {
+            continue;
+        }
+        uint64_t& word = m_pWords[y * wordsPerRow + (x >> 6)];
+        const uint64_t bit = 1ull << (x & 63);
+        if (golEditedCell((word & bit) != 0, states[i])) {
+            word |= bit;
+        } else {
+            word &= ~bit;
+        }
+    }
+}
+
+// Limits output points to the cells in [x0, x1) x [y0, y1), clipped to
+// the grid. Takes effect from the next update or collect.
+void CppBitsComputer::setViewport(int x0, int y0, int x1, int y1)
+{
+    m_view = golClampViewport(x0, y0, x1, y1, rows, cols);
+}
+
+void CppBitsComputer::setBoundary(int mode)
+{
+    m_boundary = mode;
+}
+
+float* CppBitsComputer::update(){
+    int64_t k = 0;
+    const float halfCell = cellSize * 0.5f;
+
+    // Rows that stand in for the ones across the top and bottom edges
+    const uint64_t* top = nullptr;
+    const uint64_t* bottom = nullptr;
+    if (m_boundary == kBoundaryTorus) {
+        top = m_pWords + (rows - 1) * wordsPerRow;
+        bottom = m_pWords;
+    } else if (m_boundary == kBoundaryKlein) {
+        mirrorRow(m_pWords + (rows - 1) * wordsPerRow, m_pGhostTop);
+        mirrorRow(m_pWords, m_pGhostBottom);
+        top = m_pGhostTop;
+        bottom = m_pGhostBottom;
+    }
+
+    for (int y = 0; y < rows; y++) {
+        const uint64_t* row = m_pWords + y * wordsPerRow;
+        const uint64_t* above = (y > 0) ? row - wordsPerRow : top;
+        const uint64_t* below = (y < rows - 1) ? row + wordsPerRow : bottom;
+        uint64_t* out = m_pNewWords + y * wordsPerRow;
+
+        updateRow(above, row, below, out);
+        if (m_boundary != kBoundaryDead) {
+            // The word kernel treats the columns past either end as dead
+            fixEdgeCell(0, y, out);
+            fixEdgeCell(cols - 1, y, out);
+        }
+        k = collectRow(out, y, k, halfCell);
+    }
+    setAliveCount(k);
+
+    // Swap grids
+    uint64_t* temp = m_pWords;
+    m_pWords = m_pNewWords;
+    m_pNewWords = temp;
+
+    return m_pAliveLocs;
+}
+
+// Rebuilds m_pAliveLocs from the current generation.
+float* CppBitsComputer::collect(){
+    int64_t k = 0;
+    const float halfCell = cellSize * 0.5f;
+    for (int y = 0; y < rows; y++) {
+        k = collectRow(m_pWords + y * wordsPerRow, y, k, halfCell);
+    }
+    setAliveCount(k);
+    return m_pAliveLocs;
+}
+
+// Writes row with its columns in reverse order, as seen across the top or
+// bottom edge of a Klein bottle.
+void CppBitsComputer::mirrorRow(const uint64_t* row, uint64_t* out)
+{
+    memset(out, 0, wordsPerRow * sizeof(uint64_t));
+    for (int x = 0; x < cols; x++) {
+        const int src = cols - 1 - x;
+        out[x >> 6] |= ((row[src >> 6] >> (src & 63)) & 1) << (x & 63);
+    }
+}
+
+bool CppBitsComputer::cellAt(int x, int y)
+{
+    if (!golWrapCell(x, y, rows, cols, m_boundary)) {
+        return false;
+    }
+    return (m_pWords[y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+}
+
+// Recomputes cell (x, y) of out with the neighbours the boundary maps in.
+void CppBitsComputer::fixEdgeCell(int x, int y, uint64_t* out)
+{
+    int n = 0;
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if (dx || dy) {
+                n += cellAt(x + dx, y + dy);
+            }
+        }
+    }
+    const uint64_t bit = 1ull << (x & 63);
+    if (n == 3 || (n == 2 && cellAt(x, y))) {
+        out[x >> 6] |= bit;
+    } else {
+        out[x >> 6] &= ~bit;
+    }
+}
+
+// Computes one row of the next generation 64 cells at a time. Neighbour
+// counts are accumulated bit-sliced with full adders, so each bit position
+// of the ones/twos/fours planes holds that column's count.
+void CppBitsComputer::updateRow(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out)
+{
+    for (int w = 0; w < wordsPerRow; w++) {
+        const bool hasPrev = w > 0;
+        const bool hasNext = w < wordsPerRow - 1;
+
+        // Row above: west, centre, east
+        uint64_t aC = 0, aW = 0, aE = 0;
+        if (above) {
+            aC = above[w];
+            aW = (aC << 1) | (hasPrev ? above[w - 1] >> 63 : 0);
+            aE = (aC >> 1) | (hasNext ? above[w + 1] << 63 : 0);
+        }
+
+        // Own row: west and east only
+        const uint64_t c = row[w];
+        const uint64_t mW = (c << 1) | (hasPrev ? row[w - 1] >> 63 : 0);
+        const uint64_t mE = (c >> 1) | (hasNext ? row[w + 1] << 63 : 0);
+
+        // Row below: west, centre, east
+        uint64_t bC = 0, bW = 0, bE = 0;
+        if (below) {
+            bC = below[w];
+            bW = (bC << 1) | (hasPrev ? below[w - 1] >> 63 : 0);
+            bE = (bC >> 1) | (hasNext ? below[w + 1] << 63 : 0);
+        }
+
+        // Column sums of each row as 2-bit numbers
+        const uint64_t aX = aW ^ aC;
+        const uint64_t aS = aX ^ aE;
+        const uint64_t aCarry = (aW & aC) | (aX & aE);
+        const uint64_t mS = mW ^ mE;
+        const uint64_t mCarry = mW & mE;
+        const uint64_t bX = bW ^ bC;
+        const uint64_t bS = bX ^ bE;
+        const uint64_t bCarry = (bW & bC) | (bX & bE);
+
+        // Ones plane and its carry into the twos
+        const uint64_t sX = aS ^ mS;
+        const uint64_t ones = sX ^ bS;
+        const uint64_t onesCarry = (aS & mS) | (sX & bS);
+
+        // Twos plane: four weight-2 inputs, carries go to the fours
+        const uint64_t cX = aCarry ^ mCarry;
+        const uint64_t t = cX ^ bCarry;
+        const uint64_t tCarry = (aCarry & mCarry) | (cX & bCarry);
+        const uint64_t twos = t ^ onesCarry;
+        const uint64_t fours = tCarry | (t & onesCarry);
+
+        // Alive next if count is 3, or 2 and currently alive
+        out[w] = twos & ~fours & (ones | c);
+    }
+    out[wordsPerRow - 1] &= lastWordMask;
+}
+
+// Records k floats as this frame's output and zeroes what is left of a
+// larger previous population, so the buffer stays (0, 0) terminated without
+// clearing all rows * cols points every frame.
+void CppBitsComputer::setAliveCount(int64_t k)
+{
+    reserveAlive(k + 2, k);
+    if (k < m_aliveCount * 2) {
+        memset(m_pAliveLocs + k, 0, (m_aliveCount * 2 - k) * sizeof(float));
+    }
+    m_aliveCount = k / 2;
+}
+
+// Makes room for need floats in m_pAliveLocs, keeping the first keep, see
+// golReservePoints.
+void CppBitsComputer::reserveAlive(int64_t need, int64_t keep)
+{
+    golReservePoints(m_pAliveLocs, m_aliveCapacity, need, keep, (int64_t)rows * cols * 2 + 2);
+}
+
+// Appends the live cells of row y that fall in the viewport to
+// m_pAliveLocs from index k, growing the buffer by the row's population
+// first.
+int64_t CppBitsComputer::collectRow(const uint64_t* row, int y, int64_t k, float halfCell)
+{
+    if (y < m_view.y0 || y >= m_view.y1 || m_view.x0 >= m_view.x1) {
+        return k;
+    }
+    const float fy = y * cellSize + halfCell;
+    // Only the words the viewport touches, with the columns outside it
+    // masked off the first and last
+    const int firstWord = m_view.x0 >> 6;
+    const int endWord = (m_view.x1 + 63) >> 6;
+    int live = 0;
+    for (int w = firstWord; w < endWord; w++) {
+        live += __builtin_popcountll(row[w]);
+    }
+    reserveAlive(k + live * 2 + 2, k);
+    for (int w = firstWord; w < endWord; w++) {
+        uint64_t bits = row[w];
+        if (w == firstWord) {
+            bits &= ~0ull << (m_view.x0 & 63);
+        }
+        if (w == endWord - 1 && (m_view.x1 & 63)) {
+            bits &= (1ull << (m_view.x1 & 63)) - 1;
+        }
+        while (bits) {
+            int x = (w << 6) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            m_pAliveLocs[k++] = x * cellSize + halfCell;
+            m_pAliveLocs[k++] = fy;
+        }
+    }
+    return k;
+}
@@ -0,0 +1,48 @@
+//
+#pragma once
+#include <cstdint>
+#include "cppSeed.hpp"
+#include "cppViewport.hpp"
+#include "cppPoints.hpp"
+
+// Bit-packed engine: 64 cells per uint64_t, bit i of word w is column w*64+i.
+class CppBitsComputer
+{
+    uint64_t *m_pWords;    // Current generation, rows * wordsPerRow
+    uint64_t *m_pNewWords; // Next generation (pre-allocated)
+    uint64_t *m_pGhostTop;    // Klein bottle: mirrored copies of the last
+    uint64_t *m_pGhostBottom; // and first rows
+    float *m_pAliveLocs = nullptr;  // i_0, j_0, i_1, j_1, ...
+    int rows = 0;
+    int cols = 0;
+    int wordsPerRow = 0;
+    uint64_t lastWordMask = ~0ull; // Valid columns of the last word in a row
+    int m_boundary = 0;    // GolBoundary
+    int64_t m_aliveCount = 0;  // Points written to m_pAliveLocs by the last frame
+    int64_t m_aliveCapacity = 0;  // Floats allocated for m_pAliveLocs
+    GolViewport m_view{};  // Cells that get output points, see setViewport
+    double cellSize = 0;
+
+public:
+    CppBitsComputer(int32_t nRows, int32_t nCols, double cellSize, const void* cells = nullptr, int format = kCellFormatBytes);
+    ~CppBitsComputer();
+    float* update();
+    float* collect();
+    void setBoundary(int mode);
+    void setViewport(int x0, int y0, int x1, int y1);
+    void seed(uint32_t seed, double density);
+    void load(const void* cells, int format = kCellFormatBytes);
+    void applyEdits(const int32_t* xy, const uint8_t* states, int n);
+    int64_t aliveCount() const { return m_aliveCount; }
+
+private:
+    void initData(const void* cells, int format);
+    void populateWithBools();
+    void updateRow(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out);
+    void mirrorRow(const uint64_t* row, uint64_t* out);
+    bool cellAt(int x, int y);
+    void fixEdgeCell(int x, int y, uint64_t* out);
+    int64_t collectRow(const uint64_t* row, int y, int64_t k, float halfCell);
+    void reserveAlive(int64_t need, int64_t keep);
+    void setAliveCount(int64_t k);
+};
@@ -0,0 +1,76 @@
+#include <cstdint>
+#include "cppBitsComputer.hpp"
+#define EXPORT extern "C" __attribute__((visibility("default"))) __attribute__((used))
+
+CppBitsComputer* cppBitsComp = nullptr;
+
+EXPORT
+void initCppBits(int nRows, int nCols, double cellSize){
+    cppBitsComp = new CppBitsComputer(nRows, nCols, cellSize);
+}
+
+// Same as initCppBits, but starts from cells (rows * cols, in the GolCellFormat
+// given by format: 0 = bytes, 1 = bits, 2 = floats) instead of a random
+// soup. The cells are converted in one pass and not kept.
+EXPORT
+void initCppBitsFrom(int nRows, int nCols, double cellSize, const void* cells, int format){
+    cppBitsComp = new CppBitsComputer(nRows, nCols, cellSize, cells, format);
+}
+
+EXPORT
+float* updateCppBits(){
+    auto retVal = cppBitsComp->update();
+    return retVal;
+}
+
+// Same as updateCppBits, and writes the number of live cells to count. Only
+// the first 2 * count floats of the returned buffer are meaningful.
+EXPORT
+float* updateCountedCppBits(int64_t* count){
+    auto retVal = cppBitsComp->update();
+    *count = cppBitsComp->aliveCount();
+    return retVal;
+}
+
+// Replaces the grid with a random soup; the same seed and density give
+// the same soup on every platform.
+EXPORT
+void seedCppBits(uint32_t seed, double density){
+    cppBitsComp->seed(seed, density);
+}
+
+// Replaces the grid with rows * cols bytes in row-major order, non-zero
+// meaning alive.
+EXPORT
+void loadCellsCppBits(const uint8_t* cells){
+    cppBitsComp->load(cells);
+}
+
+// Sets or toggles n cells between generations without rebuilding the
+// engine: cell (xy[2i], xy[2i+1]) takes states[i] (0 = dead, 1 = alive,
+// 2 = toggle). Cells outside the grid are ignored.
+EXPORT
+void applyEditsCppBits(const int32_t* xy, const uint8_t* states, int n){
+    cppBitsComp->applyEdits(xy, states, n);
+}
+
+// Restricts output to the cells in [x0, x1) x [y0, y1) (clipped to the
+// grid), e.g. the part that is on screen. Cells outside are still
+// simulated. Counts and buffers then cover the viewport only.
+EXPORT
+void setViewportCppBits(int x0, int y0, int x1, int y1){
+    cppBitsComp->setViewport(x0, y0, x1, y1);
+}
+
+// Edge handling, see GolBoundary: 0 = dead border, 1 = torus, 2 = Klein bottle.
+EXPORT
+void setBoundaryCppBits(int mode){
+    cppBitsComp->setBoundary(mode);
+}
+
+EXPORT
+void destructCppBits(){
+    delete cppBitsComp;
+    cppBitsComp = nullptr;
+}
+
@@ -0,0 +1,57 @@
+#include "cppBoundary.hpp"
+#include <cstring>
+
+void golRefreshGhosts(uint8_t* grid, int rows, int cols, int mode)
+{
+    const int64_t stride = cols + 2;
+    uint8_t* top = grid;
+    uint8_t* bottom = grid + (rows + 1) * stride;
+
+    if (mode == kBoundaryTorus || mode == kBoundaryKlein) {
+        // Columns first so the corner ghosts pick up the wrapped columns
+        for (int y = 1; y <= rows; y++) {
+            uint8_t* row = grid + y * stride;
+            row[0] = row[cols];
+            row[cols + 1] = row[1];
+        }
+        if (mode == kBoundaryTorus) {
+            memcpy(top, grid + rows * stride, stride);
+            memcpy(bottom, grid + stride, stride);
+            return;
+        }
+        // Klein bottle: the rows across the top and bottom edges are mirrored
+        const uint8_t* last = grid + rows * stride;
+        const uint8_t* first = grid + stride;
+        for (int i = 0; i < stride; i++) {
+            top[i] = last[stride - 1 - i];
+            bottom[i] = first[stride - 1 - i];
+        }
+        return;
+    }
+
+    for (int y = 1; y <= rows; y++) {
+        uint8_t* row = grid + y * stride;
+        row[0] = 0;
+        row[cols + 1] = 0;
+    }
+    memset(top, 0, stride);
+    memset(bottom, 0, stride);
+}
+
+bool golWrapCell(int& x, int& y, int rows, int cols, int mode)
+{
+    if (x >= 0 && x < cols && y >= 0 && y < rows) {
+        return true;
+    }
+    if (mode == kBoundaryDead) {
+        return false;
+    }
+    x = (x + cols) % cols;
+    if (y < 0 || y >= rows) {
+        y = (y + rows) % rows;
+        if (mode == kBoundaryKlein) {
+            x = cols - 1 - x;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,22 @@
+//
+#pragma once
+#include <cstdint>
+
+// Boundary handling for grids stored with a one-cell ghost frame, i.e.
+// (rows + 2) x (cols + 2) bytes with cell (x, y) at (y + 1) * (cols + 2) + x + 1.
+// Refreshing the frame before a generation lets every cell, edges included,
+// go through the same branch-free row kernel.
+enum GolBoundary
+{
+    kBoundaryDead = 0,   // Cells outside the grid are always dead
+    kBoundaryTorus = 1,  // Both axes wrap around, as in golKernel.metal
+    kBoundaryKlein = 2,  // Columns wrap; rows wrap with a left-right flip
+};
+
+// Maps a neighbour coordinate that may lie one cell outside the grid back
+// into it. Returns false when the cell is outside a dead boundary. Meant for
+// the few edge cells engines fix up individually, not for hot loops.
+bool golWrapCell(int& x, int& y, int rows, int cols, int mode);
+
+// Fills the ghost frame of grid from its edge cells for the given mode.
+void golRefreshGhosts(uint8_t* grid, int rows, int cols, int mode);
@@ -1,22 +1,213 @@
 #include <cstdint>
 #include "cppComputer.hpp"
+#include "cppRunner.hpp"
 #define EXPORT extern "C" __attribute__((visibility("default"))) __attribute__((used))
 
 CppComputer* cppComp = nullptr;
+CppRunner* cppRunner = nullptr;  // Created by the first startAsyncCpp
+int64_t cppCompCells = 0;
 
 EXPORT
 void initCpp(int nRows, int nCols, double cellSize){
+    cppCompCells = (int64_t)nRows * nCols;
     cppComp = new CppComputer(nRows, nCols, cellSize);
 }
 
+// Same as initCpp, but starts from cells (rows * cols, in the GolCellFormat
+// given by format: 0 = bytes, 1 = bits, 2 = floats) instead of a random
+// soup. The cells are converted in one pass and not kept.
+EXPORT
+void initCppFrom(int nRows, int nCols, double cellSize, const void* cells, int format){
+    cppCompCells = (int64_t)nRows * nCols;
+    cppComp = new CppComputer(nRows, nCols, cellSize, cells, format);
+}
+
 EXPORT
 float* updateCpp(){
     auto retVal = cppComp->update();
     return retVal;
 }
 
+// Same as updateCpp, and writes the number of live cells to count. Only
+// the first 2 * count floats of the returned buffer are meaningful.
+EXPORT
+float* updateCountedCpp(int64_t* count){
+    auto retVal = cppComp->update();
+    *count = cppComp->aliveCount();
+    return retVal;
+}
+
+// Advances one generation and lists only the cells that changed, within
+// the viewport: born receives a buffer of bornCount "x, y" points that
+// came alive and died one of diedCount points that died, both laid out
+// like updateCpp's output. The live cell buffer is not rebuilt; call
+// collectAliveCpp for a full frame, e.g. after moving the viewport.
+EXPORT
+void updateDeltasCpp(const float** born, int64_t* bornCount, const float** died, int64_t* diedCount){
+    cppComp->updateDeltas();
+    *born = cppComp->born();
+    *bornCount = cppComp->bornCount();
+    *died = cppComp->died();
+    *diedCount = cppComp->diedCount();
+}
+
+// Live cells in the buffer returned by the last update or collect.
+EXPORT
+int64_t aliveCountCpp(){
+    return cppComp->aliveCount();
+}
+
+// Advances gens generations in cache-sized blocks and returns the live
+// cells of the last one.
+EXPORT
+float* updateNCpp(int gens){
+    auto retVal = cppComp->updateN(gens);
+    return retVal;
+}
+
+// Advances generations without rebuilding the output buffer.
+EXPORT
+void stepCpp(int generations){
+    cppComp->step(generations);
+}
+
+// Rebuilds the output buffer from the current generation.
+EXPORT
+float* collectAliveCpp(){
+    auto retVal = cppComp->collect();
+    return retVal;
+}
+
+// Replaces the grid with a random soup; the same seed and density give
+// the same soup on every platform.
+EXPORT
+void seedCpp(uint32_t seed, double density){
+    cppComp->seed(seed, density);
+}
+
+// Replaces the grid with rows * cols bytes in row-major order, non-zero
+// meaning alive.
+EXPORT
+void loadCellsCpp(const uint8_t* cells){
+    cppComp->load(cells);
+}
+
+// Sets or toggles n cells between generations without rebuilding the
+// engine: cell (xy[2i], xy[2i+1]) takes states[i] (0 = dead, 1 = alive,
+// 2 = toggle). Cells outside the grid are ignored.
+EXPORT
+void applyEditsCpp(const int32_t* xy, const uint8_t* states, int n){
+    cppComp->applyEdits(xy, states, n);
+}
+
+// Copies the per-phase timings accumulated since the last reset to out.
+EXPORT
+void getStatsCpp(GolStats* out){
+    *out = cppComp->stats();
+}
+
+EXPORT
+void resetStatsCpp(){
+    cppComp->resetStats();
+}
+
+// Restricts output to the cells in [x0, x1) x [y0, y1) (clipped to the
+// grid), e.g. the part that is on screen. Cells outside are still
+// simulated. Counts and buffers then cover the viewport only.
+EXPORT
+void setViewportCpp(int x0, int y0, int x1, int y1){
+    cppComp->setViewport(x0, y0, x1, y1);
+}
+
+// Switches the output to one weighted point "x, y, weight" per live
+// 2^level x 2^level block (level 1 to 6), the weight being its live
+// fraction, for zoomed-out views; 0 goes back to a point per live cell.
+// Counts then count weighted points, see cppDensity.hpp.
+EXPORT
+void setLodCpp(int level){
+    cppComp->setLod(level);
+}
+
+// Switches the per-cell output to GolPointFormat format: 0 = "x, y" float
+// centres, 1 = one packed word per live cell, x | y << 16, for consumers
+// that apply the cell size themselves. Density output is not affected.
+// Returns 0, or -1 for an unknown format or a side over 65536 cells.
+EXPORT
+int setPointFormatCpp(int format){
+    return cppComp->setPointFormat(format) ? 0 : -1;
+}
+
+// Draws the current generation into pixels, a width x height buffer in
+// GolPixelFormat format (0 = RGBA8, 1 = 8-bit gray), instead of listing
+// live cells; after stepCpp this gives one image per frame. Cell
+// (x, y) covers (x, y) * cellPixels scene units and scene point s lands
+// on pixel s * zoom + offset. Colours are 0xAARRGGBB; pixels off the grid
+// get deadColor.
+EXPORT
+void renderCpp(uint8_t* pixels, int width, int height, int format, double cellPixels, double zoom,
+               double offsetX, double offsetY, uint32_t aliveColor, uint32_t deadColor){
+    const GolRaster raster{pixels, width, height, format, cellPixels, zoom, offsetX, offsetY, aliveColor, deadColor};
+    cppComp->render(raster);
+}
+
+// Edge handling, see GolBoundary: 0 = dead border, 1 = torus, 2 = Klein bottle.
+EXPORT
+void setBoundaryCpp(int mode){
+    cppComp->setBoundary(mode);
+}
+
+// Steps the engine on a background thread at gensPerSecond (<= 0: as fast
+// as possible) until stopAsyncCpp. Calling it again only changes the
+// rate. While it runs, use only latestFrameCpp, setTargetRateCpp and
+// stopAsyncCpp; everything else would race with the simulation thread.
+EXPORT
+void startAsyncCpp(double gensPerSecond){
+    if (!cppRunner) {
+        cppRunner = new CppRunner(cppCompCells, [](int64_t* count, int32_t* pointFloats, int32_t* lod) {
+            const float* locs = cppComp->update();
+            *count = cppComp->aliveCount();
+            *pointFloats = cppComp->pointFloats();
+            *lod = cppComp->lod();
+            return locs;
+        });
+    }
+    cppRunner->start(gensPerSecond);
+}
+
+EXPORT
+void setTargetRateCpp(double gensPerSecond){
+    if (cppRunner) {
+        cppRunner->setTargetRate(gensPerSecond);
+    }
+}
+
+// The newest frame the background thread has finished, without waiting
+// for it, with its layout: count points of pointFloats 32-bit words each,
+// at density level lod (0: per-cell output, packed when pointFloats is 1).
+// generation counts the generations stepped since startAsyncCpp.
+// Any out-param may be null. Before the first startAsyncCpp the frame
+// is empty. The buffer is valid until the next call.
+EXPORT
+float* latestFrameCpp(int64_t* count, int32_t* pointFloats, int32_t* lod, uint64_t* generation){
+    if (!cppRunner) {
+        return CppRunner::emptyFrame(count, pointFloats, lod, generation);
+    }
+    return cppRunner->latest(count, pointFloats, lod, generation);
+}
+
+// Stops the background thread; returns once it has finished its last
+// generation, after which the other calls may be used again.
+EXPORT
+void stopAsyncCpp(){
+    if (cppRunner) {
+        cppRunner->stop();
+    }
+}
+
 EXPORT
 void destructCpp(){
+    delete cppRunner;
+    cppRunner = nullptr;
     delete cppComp;
     cppComp = nullptr;
 }
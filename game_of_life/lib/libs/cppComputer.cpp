@@ -1,12 +1,34 @@
 #include "cppComputer.hpp"
+#include "cppSimdKernel.hpp"
+#include "cppBoundary.hpp"
+#include "cppSeed.hpp"
+#include "cppViewport.hpp"
+#include "cppDensity.hpp"
+#include "cppRaster.hpp"
+#include "cppPoints.hpp"
 #include <ctime>
 #include <cstdlib>
 #include <cstring>
 
-CppComputer::CppComputer(int32_t nRows, int32_t nCols, double cellSize)
+// updateN works on blocks of kBlockRows x kBlockCols cells. A block plus a
+// halo of up to kMaxBlockGens cells on each side is stepped in scratch
+// buffers that stay in cache, so the grid is streamed from memory once per
+// kMaxBlockGens generations instead of once per generation.
+static const int kBlockRows = 128;
+static const int kBlockCols = 256;
+static const int kMaxBlockGens = 16;
+static const int kScratchSize = (kBlockRows + 2 * kMaxBlockGens + 2) * (kBlockCols + 2 * kMaxBlockGens + 2);
+
+// update() steps and collects this many rows at a time, so the stats can
+// time the two phases apart while the rows are still in cache.
+static const int kStatsBandRows = 16;
+
+CppComputer::CppComputer(int32_t nRows, int32_t nCols, double cellSize, const void* cells, int format)
 : rows(nRows), cols(nCols), cellSize(cellSize)
 {
-    initData();
+    stride = cols + 2;
+    m_view = golFullViewport(rows, cols);
+    initData(cells, format);
 }
 
 CppComputer::~CppComputer()
@@ -14,119 +36,468 @@ CppComputer::~CppComputer()
     delete[] m_pGrid;
     delete[] m_pNewGrid;
     delete[] m_pAliveLocs;
+    delete[] m_pAliveCells;
+    delete[] m_pDensity;
+    delete[] m_pDensitySums;
+    delete[] m_pRasterColumns;
+    delete[] m_pBorn;
+    delete[] m_pDied;
+    delete[] m_pBlockA;
+    delete[] m_pBlockB;
 }
 
-void CppComputer::initData()
+// Starts from cells when given, see load, and from the legacy soup
+// otherwise.
+void CppComputer::initData(const void* cells, int format)
 {
-    m_pGrid = new uint8_t[rows * cols];
-    m_pNewGrid = new uint8_t[rows * cols];
-    populateWithBools();
-    m_pAliveLocs = new float[rows * cols * 2];
+    m_pGrid = new uint8_t[(rows + 2) * stride]();
+    m_pNewGrid = new uint8_t[(rows + 2) * stride]();
+    if (cells) {
+        load(cells, format);
+    } else {
+        populateWithBools();
+    }
+    m_pBlockA = new uint8_t[kScratchSize];
+    m_pBlockB = new uint8_t[kScratchSize];
 }
 
 void CppComputer::populateWithBools()
 {
     srand(7);
-    for (int i = 0; i < rows * cols; ++i)
+    for (int y = 0; y < rows; ++y)
     {
-        m_pGrid[i] = rand() % 2;
+        for (int x = 0; x < cols; ++x)
+        {
+            m_pGrid[(y + 1) * stride + x + 1] = rand() % 2;
+        }
+    }
+}
+
+// Replaces the grid with a soup of the given density, see golSeedSoup.
+void CppComputer::seed(uint32_t seed, double density)
+{
+    golSeedSoup(m_pGrid + stride + 1, rows, cols, stride, seed, density);
+}
+
+// Replaces the grid with cells, rows * cols cells in the given
+// GolCellFormat.
+void CppComputer::load(const void* cells, int format)
+{
+    golImportCells(m_pGrid + stride + 1, rows, cols, stride, cells, format);
+}
+
+// Applies n edits between generations: cell (xy[2i], xy[2i+1]) takes
+// GolEdit states[i]. Cells outside the grid are ignored. The output buffer
+// is not touched until the next update or collect.
+void CppComputer::applyEdits(const int32_t* xy, const uint8_t* states, int n)
+{
+    for (int i = 0; i < n; i++) {
+        const int x = xy[2 * i];
+        const int y = xy[2 * i + 1];
+        if (x < 0 || y < 0 || x >= cols || y >= rows) {
+            continue;
+        }
+        uint8_t& cell = m_pGrid[(y + 1) * stride + x + 1];
+        cell = golEditedCell(cell, states[i]);
     }
 }
 
+// Limits output points to the cells in [x0, x1) x [y0, y1), clipped to
+// the grid. Takes effect from the next update or collect.
+void CppComputer::setViewport(int x0, int y0, int x1, int y1)
+{
+    m_view = golClampViewport(x0, y0, x1, y1, rows, cols);
+}
+
+// Switches the output between one point per live cell (level 0) and one
+// weighted point per 2^level x 2^level block, see cppDensity.hpp. The
+// blocks are summed in the same pass that steps the rows. Takes effect
+// from the next update or collect.
+void CppComputer::setLod(int level)
+{
+    m_lod = level < 0 ? 0 : (level > kMaxDensityLevel ? kMaxDensityLevel : level);
+    if (m_lod && !m_pDensitySums) {
+        // Level 1 has the most blocks
+        m_pDensitySums = new uint32_t[golDensityBlocks(cols, 1)]();
+    }
+}
+
+// Switches the per-cell output between float centres and packed cell
+// coordinates, see GolPointFormat. Only the buffer of the current format
+// is kept, and regrown from scratch by the next frame. Takes effect from
+// the next update or collect; returns false, changing nothing, for an
+// unknown format or a grid too large to pack.
+bool CppComputer::setPointFormat(int format)
+{
+    if (!golPointFormatFits(format, rows, cols)) {
+        return false;
+    }
+    if (format == m_pointFormat) {
+        return true;
+    }
+    delete[] m_pAliveLocs;
+    delete[] m_pAliveCells;
+    m_pAliveLocs = nullptr;
+    m_pAliveCells = nullptr;
+    m_aliveCapacity = 0;
+    m_pointFormat = format;
+    m_aliveCount = 0;
+    return true;
+}
+
+void CppComputer::setBoundary(int mode)
+{
+    m_boundary = mode;
+}
+
 float* CppComputer::update(){
-    memset(m_pAliveLocs, 0, rows * cols * 2 * sizeof(float));
-    
-    int k = 0;
-    const float halfCell = cellSize * 0.5f;
-
-    // Process interior cells (no bounds checking needed)
-    for (int y = 1; y < rows - 1; y++) {
-        for (int x = 1; x < cols - 1; x++) {
-            int idx = y * cols + x;
-            
-            // Fast neighbor count for interior cells
-            int neighbors = 
-                m_pGrid[(y-1) * cols + (x-1)] + m_pGrid[(y-1) * cols + x] + m_pGrid[(y-1) * cols + (x+1)] +
-                m_pGrid[y * cols + (x-1)] +                                   m_pGrid[y * cols + (x+1)] +
-                m_pGrid[(y+1) * cols + (x-1)] + m_pGrid[(y+1) * cols + x] + m_pGrid[(y+1) * cols + (x+1)];
-            
-            uint8_t currentCell = m_pGrid[idx];
-            uint8_t newState = currentCell ? 
-                ((neighbors == 2 || neighbors == 3) ? 1 : 0) : 
-                ((neighbors == 3) ? 1 : 0);
-            
-            m_pNewGrid[idx] = newState;
-            
-            if (newState) {
-                m_pAliveLocs[k++] = x * cellSize + halfCell;
-                m_pAliveLocs[k++] = y * cellSize + halfCell;
-            }
+    const uint64_t start = golNowNs();
+    int64_t k = 0;
+
+    // With the ghost frame filled in, edge cells need no special casing
+    golRefreshGhosts(m_pGrid, rows, cols, m_boundary);
+    uint64_t t = golNowNs();
+    m_stats.borderNs += t - start;
+
+    for (int y0 = 0; y0 < rows; y0 += kStatsBandRows) {
+        const int y1 = (y0 + kStatsBandRows < rows) ? y0 + kStatsBandRows : rows;
+        for (int y = y0; y < y1; y++) {
+            const uint8_t* row = m_pGrid + (y + 1) * stride + 1;
+            golStepRow(row - stride, row, row + stride, m_pNewGrid + (y + 1) * stride + 1, cols);
         }
+        uint64_t stepped = golNowNs();
+        m_stats.stepNs += stepped - t;
+
+        k = m_lod ? densityRows(m_pNewGrid, y0, y1, k) : collectRows(m_pNewGrid, y0, y1, k);
+        t = golNowNs();
+        m_stats.collectNs += t - stepped;
     }
-    
-    // Process border cells with bounds checking
-    processBorderCells(k);
-    
+
+    if (m_lod) {
+        setDensityCount(k);
+    } else {
+        setAliveCount(k);
+    }
+    const uint64_t end = golNowNs();
+    m_stats.clearNs += end - t;
+    m_stats.totalNs += end - start;
+    m_stats.frames++;
+
     // Swap grids
     uint8_t* temp = m_pGrid;
     m_pGrid = m_pNewGrid;
     m_pNewGrid = temp;
     
-    return m_pAliveLocs;
+    return output();
 }
 
-void CppComputer::processBorderCells(int& k) {
-    const float halfCell = cellSize * 0.5f;
-    
-    // Process top and bottom rows
-    for (int x = 0; x < cols; x++) {
-        // Top row
-        processSingleCell(x, 0, k, halfCell);
-        // Bottom row
-        if (rows > 1) {
-            processSingleCell(x, rows - 1, k, halfCell);
-        }
+// The buffer update and collect fill: weighted points, packed cells or
+// cell centres. Packed cells go out through the same float pointer and
+// are only ever copied as raw words.
+float* CppComputer::output()
+{
+    if (m_lod) {
+        return m_pDensity;
     }
-    
-    // Process left and right columns (excluding corners already processed)
-    for (int y = 1; y < rows - 1; y++) {
-        // Left column
-        processSingleCell(0, y, k, halfCell);
-        // Right column
-        if (cols > 1) {
-            processSingleCell(cols - 1, y, k, halfCell);
+    return m_pointFormat == kPointFormatCells ? reinterpret_cast<float*>(m_pAliveCells) : m_pAliveLocs;
+}
+
+// Advances one generation like update(), but instead of all live cells
+// lists the ones that changed: cells born go to m_pBorn and cells that
+// died to m_pDied, both limited to the viewport. They are found by
+// comparing the two grids row by row right after each band is stepped.
+// m_pAliveLocs is left as it was; collect() rebuilds it, e.g. to resync
+// after the viewport moved.
+void CppComputer::updateDeltas(){
+    const uint64_t start = golNowNs();
+    golRefreshGhosts(m_pGrid, rows, cols, m_boundary);
+    uint64_t t = golNowNs();
+    m_stats.borderNs += t - start;
+
+    int64_t bornK = 0;
+    int64_t diedK = 0;
+    const int width = m_view.x1 - m_view.x0;
+    const int64_t deltaLimit = (int64_t)rows * cols * 2 + 2;
+    for (int y0 = 0; y0 < rows; y0 += kStatsBandRows) {
+        const int y1 = (y0 + kStatsBandRows < rows) ? y0 + kStatsBandRows : rows;
+        for (int y = y0; y < y1; y++) {
+            const uint8_t* row = m_pGrid + (y + 1) * stride + 1;
+            golStepRow(row - stride, row, row + stride, m_pNewGrid + (y + 1) * stride + 1, cols);
+        }
+        uint64_t stepped = golNowNs();
+        m_stats.stepNs += stepped - t;
+
+        const int vy0 = y0 > m_view.y0 ? y0 : m_view.y0;
+        const int vy1 = y1 < m_view.y1 ? y1 : m_view.y1;
+        for (int y = vy0; y < vy1; y++) {
+            const int64_t offset = (y + 1) * stride + 1 + m_view.x0;
+            // Room for the whole row in either list, and a terminator
+            golReservePoints(m_pBorn, m_bornCapacity, bornK + width * 2 + 2, bornK, deltaLimit);
+            golReservePoints(m_pDied, m_diedCapacity, diedK + width * 2 + 2, diedK, deltaLimit);
+            golCollectDeltaRow(m_pGrid + offset, m_pNewGrid + offset, width, m_view.x0, y, cellSize,
+                               m_pBorn, &bornK, m_pDied, &diedK);
         }
+        t = golNowNs();
+        m_stats.collectNs += t - stepped;
     }
+
+    setDeltaCounts(bornK, diedK);
+    const uint64_t end = golNowNs();
+    m_stats.clearNs += end - t;
+    m_stats.totalNs += end - start;
+    m_stats.frames++;
+
+    uint8_t* temp = m_pGrid;
+    m_pGrid = m_pNewGrid;
+    m_pNewGrid = temp;
 }
 
-void CppComputer::processSingleCell(int x, int y, int& k, float halfCell) {
-    int idx = y * cols + x;
-    int neighbors = countNeighbors(x, y);
-    
-    uint8_t currentCell = m_pGrid[idx];
-    uint8_t newState = currentCell ? 
-        ((neighbors == 2 || neighbors == 3) ? 1 : 0) : 
-        ((neighbors == 3) ? 1 : 0);
-    
-    m_pNewGrid[idx] = newState;
-    
-    if (newState) {
-        m_pAliveLocs[k++] = x * cellSize + halfCell;
-        m_pAliveLocs[k++] = y * cellSize + halfCell;
+// Advances gens generations and returns the live cells of the last one.
+float* CppComputer::updateN(int gens){
+    step(gens);
+    return collect();
+}
+
+// Advances gens generations without touching m_pAliveLocs.
+void CppComputer::step(int gens){
+    const uint64_t start = golNowNs();
+    stepBlocked(gens);
+    const uint64_t elapsed = golNowNs() - start;
+    m_stats.stepNs += elapsed;
+    m_stats.totalNs += elapsed;
+}
+
+// Rebuilds m_pAliveLocs from the current generation.
+float* CppComputer::collect(){
+    const uint64_t start = golNowNs();
+    const int64_t k = m_lod ? densityRows(m_pGrid, 0, rows, 0) : collectAlive();
+    const uint64_t collected = golNowNs();
+    if (m_lod) {
+        setDensityCount(k);
+    } else {
+        setAliveCount(k);
     }
+    const uint64_t end = golNowNs();
+    m_stats.collectNs += collected - start;
+    m_stats.clearNs += end - collected;
+    m_stats.totalNs += end - start;
+    m_stats.frames++;
+    return output();
 }
 
-int32_t CppComputer::countNeighbors(int x, int y){
-    int32_t count = 0;
-    
-    for (int i = -1; i <= 1; i++) {
-        for (int j = -1; j <= 1; j++) {
-            if (i == 0 && j == 0) continue;
-            int nx = x + i, ny = y + j;
-            if (nx >= 0 && nx < cols && ny >= 0 && ny < rows) {
-                count += m_pGrid[ny * cols + nx];
+// Draws the current generation into raster, see GolRaster, instead of
+// listing its live cells. Only the grid rows that reach a pixel are read.
+void CppComputer::render(const GolRaster& raster){
+    const uint64_t start = golNowNs();
+    if (raster.width > m_rasterColumnsSize) {
+        delete[] m_pRasterColumns;
+        m_pRasterColumns = new int32_t[raster.width];
+        m_rasterColumnsSize = raster.width;
+    }
+    golRasterColumns(raster, cols, m_pRasterColumns);
+    golRasterizeRows(raster, m_pRasterColumns, m_pGrid + stride + 1, rows, stride, 0, raster.height);
+    const uint64_t elapsed = golNowNs() - start;
+    m_stats.collectNs += elapsed;
+    m_stats.totalNs += elapsed;
+    m_stats.frames++;
+}
+
+void CppComputer::stepBlocked(int gens) {
+    while (gens > 0) {
+        int passGens = gens < kMaxBlockGens ? gens : kMaxBlockGens;
+        for (int y0 = 0; y0 < rows; y0 += kBlockRows) {
+            int y1 = (y0 + kBlockRows < rows) ? y0 + kBlockRows : rows;
+            for (int x0 = 0; x0 < cols; x0 += kBlockCols) {
+                int x1 = (x0 + kBlockCols < cols) ? x0 + kBlockCols : cols;
+                stepBlock(x0, y0, x1, y1, passGens);
             }
         }
+
+        // Swap grids
+        uint8_t* temp = m_pGrid;
+        m_pGrid = m_pNewGrid;
+        m_pNewGrid = temp;
+
+        gens -= passGens;
+    }
+}
+
+// Steps the block [x0, x1) x [y0, y1) by gens generations into m_pNewGrid.
+// The block is copied with a halo of gens cells into a scratch buffer with a
+// dead one-cell frame. Halo cells next to the scratch edge are wrong after
+// each generation, but the error moves inward one cell per generation and
+// never reaches the block itself. With a dead boundary the halo is clipped
+// to the grid and the scratch frame stands in for the dead border; with a
+// torus or Klein bottle the halo is read across the wrapped edges.
+void CppComputer::stepBlock(int x0, int y0, int x1, int y1, int gens) {
+    const bool clip = m_boundary == kBoundaryDead;
+    const int ys = (clip && y0 - gens < 0) ? 0 : y0 - gens;
+    const int ye = (clip && y1 + gens > rows) ? rows : y1 + gens;
+    const int xs = (clip && x0 - gens < 0) ? 0 : x0 - gens;
+    const int xe = (clip && x1 + gens > cols) ? cols : x1 + gens;
+    const int h = ye - ys;
+    const int w = xe - xs;
+    const int blockStride = w + 2;
+
+    uint8_t* cur = m_pBlockA;
+    uint8_t* next = m_pBlockB;
+    memset(cur, 0, blockStride);
+    memset(cur + (h + 1) * blockStride, 0, blockStride);
+    memset(next, 0, blockStride);
+    memset(next + (h + 1) * blockStride, 0, blockStride);
+    for (int y = 0; y < h; y++) {
+        uint8_t* row = cur + (y + 1) * blockStride;
+        row[0] = 0;
+        copyBlockRow(row + 1, ys + y, xs, w);
+        row[w + 1] = 0;
+        next[(y + 1) * blockStride] = 0;
+        next[(y + 1) * blockStride + w + 1] = 0;
+    }
+
+    for (int g = 0; g < gens; g++) {
+        for (int y = 1; y <= h; y++) {
+            const uint8_t* row = cur + y * blockStride + 1;
+            golStepRow(row - blockStride, row, row + blockStride, next + y * blockStride + 1, w);
+        }
+        uint8_t* temp = cur;
+        cur = next;
+        next = temp;
+    }
+
+    for (int y = y0; y < y1; y++) {
+        memcpy(m_pNewGrid + (y + 1) * stride + x0 + 1, cur + (y - ys + 1) * blockStride + (x0 - xs + 1), x1 - x0);
+    }
+}
+
+// Copies cells [xs, xs + w) of row y into dst, wrapping coordinates that
+// fall outside the grid (only reached with a torus or Klein boundary). On a
+// Klein bottle every crossing of the top or bottom edge mirrors the row.
+void CppComputer::copyBlockRow(uint8_t* dst, int y, int xs, int w) {
+    int wy = ((y % rows) + rows) % rows;
+    bool mirrored = m_boundary == kBoundaryKlein && (((y - wy) / rows) & 1);
+    const uint8_t* src = m_pGrid + (wy + 1) * stride + 1;
+    int x = ((xs % cols) + cols) % cols;
+    if (mirrored) {
+        for (int i = 0; i < w; i++) {
+            dst[i] = src[cols - 1 - x];
+            x = (x + 1 == cols) ? 0 : x + 1;
+        }
+        return;
+    }
+    while (w > 0) {
+        int n = (cols - x < w) ? cols - x : w;
+        memcpy(dst, src + x, n);
+        dst += n;
+        w -= n;
+        x = 0;
+    }
+}
+
+// Records k words (floats, or packed cells) as this frame's output and
+// zeroes what is left of a larger previous population, so the buffer stays
+// zero terminated without clearing all rows * cols points every frame.
+void CppComputer::setAliveCount(int64_t k)
+{
+    const int words = golPointWords(m_pointFormat);
+    reserveAlive(k + words, k);
+    if (k < m_aliveCount * words) {
+        if (m_pointFormat == kPointFormatCells) {
+            memset(m_pAliveCells + k, 0, (m_aliveCount - k) * sizeof(uint32_t));
+        } else {
+            memset(m_pAliveLocs + k, 0, (m_aliveCount * 2 - k) * sizeof(float));
+        }
+    }
+    m_aliveCount = k / words;
+}
+
+// Same as setAliveCount for the weighted points in m_pDensity.
+void CppComputer::setDensityCount(int64_t k)
+{
+    reserveDensity(k + kDensityPointFloats, k);
+    if (k < m_densityCount * kDensityPointFloats) {
+        memset(m_pDensity + k, 0, (m_densityCount * kDensityPointFloats - k) * sizeof(float));
+    }
+    m_densityCount = k / kDensityPointFloats;
+}
+
+// Same as setAliveCount for the born and died lists.
+void CppComputer::setDeltaCounts(int64_t bornK, int64_t diedK)
+{
+    const int64_t deltaLimit = (int64_t)rows * cols * 2 + 2;
+    golReservePoints(m_pBorn, m_bornCapacity, bornK + 2, bornK, deltaLimit);
+    golReservePoints(m_pDied, m_diedCapacity, diedK + 2, diedK, deltaLimit);
+    if (bornK < m_bornCount * 2) {
+        memset(m_pBorn + bornK, 0, (m_bornCount * 2 - bornK) * sizeof(float));
+    }
+    if (diedK < m_diedCount * 2) {
+        memset(m_pDied + diedK, 0, (m_diedCount * 2 - diedK) * sizeof(float));
+    }
+    m_bornCount = bornK / 2;
+    m_diedCount = diedK / 2;
+}
+
+// Makes room for need words of per-cell output, keeping the first keep,
+// see golReservePoints.
+void CppComputer::reserveAlive(int64_t need, int64_t keep)
+{
+    const int words = golPointWords(m_pointFormat);
+    const int64_t limit = (int64_t)rows * cols * words + words;
+    if (m_pointFormat == kPointFormatCells) {
+        golReservePoints(m_pAliveCells, m_aliveCapacity, need, keep, limit);
+    } else {
+        golReservePoints(m_pAliveLocs, m_aliveCapacity, need, keep, limit);
+    }
+}
+
+// Same as reserveAlive for m_pDensity, whose limit is a point per block at
+// level 1, the level with the most blocks.
+void CppComputer::reserveDensity(int64_t need, int64_t keep)
+{
+    const int64_t limit = (int64_t)golDensityBlocks(rows, 1) * golDensityBlocks(cols, 1) * kDensityPointFloats + kDensityPointFloats;
+    golReservePoints(m_pDensity, m_densityCapacity, need, keep, limit);
+}
+
+int64_t CppComputer::collectAlive() {
+    return collectRows(m_pGrid, 0, rows, 0);
+}
+
+// Appends the live cells of grid rows [y0, y1) that fall in the viewport
+// to m_pAliveLocs, or m_pAliveCells, from index k, growing the buffer a
+// row ahead. Rows outside the viewport are skipped outright.
+int64_t CppComputer::collectRows(const uint8_t* grid, int y0, int y1, int64_t k) {
+    y0 = y0 > m_view.y0 ? y0 : m_view.y0;
+    y1 = y1 < m_view.y1 ? y1 : m_view.y1;
+    const int width = m_view.x1 - m_view.x0;
+    if (m_pointFormat == kPointFormatCells) {
+        for (int y = y0; y < y1; y++) {
+            reserveAlive(k + width + 1, k);
+            k = golCollectCellsRow(grid + (y + 1) * stride + 1 + m_view.x0, width, m_view.x0, y, m_pAliveCells, k);
+        }
+        return k;
+    }
+    for (int y = y0; y < y1; y++) {
+        reserveAlive(k + width * 2 + 2, k);
+        k = golCollectRow(grid + (y + 1) * stride + 1 + m_view.x0, width, m_view.x0, y, cellSize, m_pAliveLocs, k);
+    }
+    return k;
+}
+
+// Adds the viewport part of grid rows [y0, y1) to the block sums and
+// appends a weighted point to m_pDensity from index k for every live block
+// of each block row the range completes. Rows arrive in order, so a block
+// row may span several calls.
+int64_t CppComputer::densityRows(const uint8_t* grid, int y0, int y1, int64_t k) {
+    y0 = y0 > m_view.y0 ? y0 : m_view.y0;
+    y1 = y1 < m_view.y1 ? y1 : m_view.y1;
+    const int blockMask = (1 << m_lod) - 1;
+    for (int y = y0; y < y1; y++) {
+        golDensityAddRow(grid + (y + 1) * stride + 1, m_view.x0, m_view.x1, m_lod, m_pDensitySums);
+        if ((y & blockMask) == blockMask || y + 1 == m_view.y1) {
+            const int bx0 = m_view.x0 >> m_lod;
+            const int bx1 = golDensityBlocks(m_view.x1, m_lod);
+            reserveDensity(k + (bx1 - bx0 + 1) * kDensityPointFloats, k);
+            k = golDensityFlush(m_pDensitySums, bx0, bx1, y >> m_lod, m_lod, cellSize, m_pDensity, k);
+        }
     }
-    return count;
+    return k;
 }
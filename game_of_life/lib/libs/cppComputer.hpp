@@ -1,24 +1,85 @@
 //
+#pragma once
 #include <cstdint>
+#include "cppStats.hpp"
+#include "cppSeed.hpp"
+#include "cppViewport.hpp"
+#include "cppDensity.hpp"
+#include "cppRaster.hpp"
+#include "cppPoints.hpp"
 
 class CppComputer
 {
-    uint8_t *m_pGrid;      // Current generation
+    uint8_t *m_pGrid;      // Current generation, (rows + 2) x (cols + 2) with a ghost frame
     uint8_t *m_pNewGrid;   // Next generation (pre-allocated)
-    float *m_pAliveLocs;   // i_0, j_0, i_1, j_1, ...
+    float *m_pAliveLocs = nullptr;       // i_0, j_0, i_1, j_1, ... (kPointFormatFloats)
+    uint32_t *m_pAliveCells = nullptr;   // Packed cells instead, see setPointFormat
+    float *m_pDensity = nullptr;         // Weighted points while m_lod > 0
+    uint32_t *m_pDensitySums = nullptr;  // Per block of the block row being summed
+    int32_t *m_pRasterColumns = nullptr; // Grid column per pixel column, see render
+    float *m_pBorn = nullptr;  // Cells that came alive in the last updateDeltas
+    float *m_pDied = nullptr;  // Cells that died in it
+    int m_rasterColumnsSize = 0;
+    int64_t m_aliveCapacity = 0;    // Words allocated for m_pAliveLocs or m_pAliveCells
+    int64_t m_densityCapacity = 0;  // Floats allocated for m_pDensity
+    int64_t m_bornCapacity = 0;
+    int64_t m_diedCapacity = 0;
+    uint8_t *m_pBlockA;    // Scratch for updateN: one block plus its halo
+    uint8_t *m_pBlockB;
     int rows = 0;
     int cols = 0;
+    int64_t stride = 0;   // 64-bit so row offsets of large grids do not overflow
+    int m_boundary = 0;    // GolBoundary
+    int64_t m_aliveCount = 0;  // Points written to m_pAliveLocs by the last frame
+    GolViewport m_view{};  // Cells that get output points, see setViewport
+    int m_pointFormat = kPointFormatFloats;  // GolPointFormat of the per-cell output
+    int m_lod = 0;         // Density level of the output, see setLod
+    int64_t m_densityCount = 0;  // Weighted points written to m_pDensity by the last frame
+    int64_t m_bornCount = 0;
+    int64_t m_diedCount = 0;
     double cellSize = 0;
+    GolStats m_stats{};
 
 public:
-    CppComputer(int32_t nRows, int32_t nCols, double cellSize);
+    CppComputer(int32_t nRows, int32_t nCols, double cellSize, const void* cells = nullptr, int format = kCellFormatBytes);
     ~CppComputer();
     float* update();
+    float* updateN(int gens);
+    void step(int gens);
+    float* collect();
+    void render(const GolRaster& raster);
+    void updateDeltas();
+    const float* born() const { return m_pBorn; }
+    const float* died() const { return m_pDied; }
+    int64_t bornCount() const { return m_bornCount; }
+    int64_t diedCount() const { return m_diedCount; }
+    void setBoundary(int mode);
+    void setViewport(int x0, int y0, int x1, int y1);
+    void setLod(int level);
+    bool setPointFormat(int format);
+    void seed(uint32_t seed, double density);
+    void load(const void* cells, int format = kCellFormatBytes);
+    void applyEdits(const int32_t* xy, const uint8_t* states, int n);
+    int64_t aliveCount() const { return m_lod ? m_densityCount : m_aliveCount; }
+    int lod() const { return m_lod; }
+    int pointFormat() const { return m_pointFormat; }
+    int pointFloats() const { return m_lod ? kDensityPointFloats : golPointWords(m_pointFormat); }
+    const GolStats& stats() const { return m_stats; }
+    void resetStats() { m_stats = GolStats{}; }
 
 private:
-    void initData();
+    void initData(const void* cells, int format);
     void populateWithBools();
-    int32_t countNeighbors(int x, int y);
-    void processBorderCells(int& k);
-    void processSingleCell(int x, int y, int& k, float halfCell);
+    void stepBlocked(int gens);
+    void stepBlock(int x0, int y0, int x1, int y1, int gens);
+    void copyBlockRow(uint8_t* dst, int y, int xs, int w);
+    int64_t collectAlive();
+    int64_t collectRows(const uint8_t* grid, int y0, int y1, int64_t k);
+    int64_t densityRows(const uint8_t* grid, int y0, int y1, int64_t k);
+    float* output();
+    void reserveAlive(int64_t need, int64_t keep);
+    void reserveDensity(int64_t need, int64_t keep);
+    void setAliveCount(int64_t k);
+    void setDensityCount(int64_t k);
+    void setDeltaCounts(int64_t bornK, int64_t diedK);
 };
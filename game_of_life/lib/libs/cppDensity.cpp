@@ -0,0 +1,77 @@
+#include "cppDensity.hpp"
+#include <cstring>
+
+int golDensityBlocks(int n, int level)
+{
+    return (n + (1 << level) - 1) >> level;
+}
+
+// Blocks of 8 cells or more are summed a block at a time, which the
+// compiler vectorizes. Narrower blocks would leave it a handful of bytes
+// per loop, so there eight cells (0 or 1 each) are loaded as one word and
+// adjacent byte lanes are added pairwise into 2-cell and 4-cell sums,
+// which never carry into the next lane. Assumes a little endian word, as
+// on every platform the app ships to.
+void golDensityAddRow(const uint8_t* row, int x0, int x1, int level, uint32_t* sums)
+{
+    const int size = 1 << level;
+    int x = x0;
+    if (level >= 3) {
+        while (x < x1) {
+            // Up to the end of x's block, or of the range
+            const int end = ((x >> level) + 1) * size < x1 ? ((x >> level) + 1) * size : x1;
+            uint32_t count = 0;
+            for (int i = x; i < end; i++) {
+                count += row[i];
+            }
+            sums[x >> level] += count;
+            x = end;
+        }
+        return;
+    }
+
+    const uint64_t kPairs = 0x00FF00FF00FF00FFull;
+    const uint64_t kQuads = 0x0000FFFF0000FFFFull;
+    for (; x < x1 && (x & 7); x++) {
+        sums[x >> level] += row[x];
+    }
+    for (; x + 8 <= x1; x += 8) {
+        uint64_t word;
+        memcpy(&word, row + x, sizeof(word));
+        if (!word) {
+            continue;
+        }
+        const uint64_t pairs = (word & kPairs) + ((word >> 8) & kPairs);
+        uint32_t* out = sums + (x >> level);
+        if (level == 1) {
+            out[0] += (uint32_t)(pairs & 0xFFFF);
+            out[1] += (uint32_t)((pairs >> 16) & 0xFFFF);
+            out[2] += (uint32_t)((pairs >> 32) & 0xFFFF);
+            out[3] += (uint32_t)(pairs >> 48);
+            continue;
+        }
+        const uint64_t quads = (pairs & kQuads) + ((pairs >> 16) & kQuads);
+        out[0] += (uint32_t)(quads & 0xFFFFFFFF);
+        out[1] += (uint32_t)(quads >> 32);
+    }
+    for (; x < x1; x++) {
+        sums[x >> level] += row[x];
+    }
+}
+
+int64_t golDensityFlush(uint32_t* sums, int bx0, int bx1, int by, int level, float cellSize, float* out, int64_t k)
+{
+    const float blockSize = (float)(1 << level) * cellSize;
+    const float weightScale = 1.0f / (float)(1 << (2 * level));
+    const float cy = (by + 0.5f) * blockSize;
+    for (int bx = bx0; bx < bx1; bx++) {
+        if (sums[bx] == 0) {
+            continue;
+        }
+        out[k++] = (bx + 0.5f) * blockSize;
+        out[k++] = cy;
+        out[k++] = sums[bx] * weightScale;
+        sums[bx] = 0;
+    }
+    return k;
+}
@@ -0,0 +1,25 @@
+//
+#pragma once
+#include <cstdint>
+
+// Level-of-detail output for zoomed-out views. At level L (1 to
+// kMaxDensityLevel) the grid is split into 2^L x 2^L blocks aligned to
+// cell (0, 0), and every block with live cells becomes one weighted point
+// "x, y, weight": the block's centre in the same units as the per-cell
+// points and its live fraction in (0, 1]. Level 0 means per-cell points.
+static const int kMaxDensityLevel = 6;
+
+// Floats per weighted point.
+static const int kDensityPointFloats = 3;
+
+// Blocks needed to cover n cells at the given level.
+int golDensityBlocks(int n, int level);
+
+// Adds the live cells of row[x0..x1), where row[0] is column 0, to the
+// per-block sums of the current block row.
+void golDensityAddRow(const uint8_t* row, int x0, int x1, int level, uint32_t* sums);
+
+// Appends a weighted point for every non-zero sum of blocks [bx0, bx1) in
+// block row by to out from index k, zeroes those sums and returns the new
+// k.
+int64_t golDensityFlush(uint32_t* sums, int bx0, int bx1, int by, int level, float cellSize, float* out, int64_t k);
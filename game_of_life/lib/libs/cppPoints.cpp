@@ -0,0 +1,17 @@
+#include "cppPoints.hpp"
+
+bool golPointFormatFits(int format, int rows, int cols)
+{
+    switch (format) {
+    case kPointFormatFloats:
+        return true;
+    case kPointFormatCells:
+        return rows <= kMaxPackedCells && cols <= kMaxPackedCells;
+    }
+    return false;
+}
+
+int golPointWords(int format)
+{
+    return format == kPointFormatCells ? 1 : 2;
+}
@@ -0,0 +1,62 @@
+//
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// Layouts of the per-cell output (no level of detail). kPointFormatFloats
+// gives "x, y" cell centres in scene units, ready for the painter, at 8
+// bytes per live cell. kPointFormatCells packs the cell coordinates into
+// one 32-bit word instead, x in the low and y in the high 16 bits, so on a
+// little-endian host the buffer reads as uint16 (x, y) pairs. The consumer
+// applies the cell size itself; the engines write half the bytes and do
+// no float math per cell.
+enum GolPointFormat
+{
+    kPointFormatFloats = 0,
+    kPointFormatCells = 1,
+};
+
+// Largest number of rows or columns kPointFormatCells can address.
+static const int kMaxPackedCells = 65536;
+
+// Whether format is a GolPointFormat a rows x cols grid can be output in.
+bool golPointFormatFits(int format, int rows, int cols);
+
+// 32-bit words per live cell in format: 2 for floats, 1 for packed cells.
+int golPointWords(int format);
+
+// Capacity, in 32-bit words, an output buffer starts with.
+static const int kMinPointWords = 4096;
+
+// Makes room for need words in buf, which holds capacity words. Output
+// buffers are sized by the population rather than the grid, so they grow:
+// to twice their capacity or to need, whichever is more, but not past
+// limit, the words a full grid would take. The first keep words are
+// copied over and the rest of the new buffer is zero, so a buffer that
+// was zero terminated stays so. A grow frees the old buffer; engines only
+// grow while filling a frame, so the pointer they return stays valid
+// until the next call, as before.
+template <typename T>
+void golReservePoints(T*& buf, int64_t& capacity, int64_t need, int64_t keep, int64_t limit)
+{
+    if (need <= capacity) {
+        return;
+    }
+    int64_t grown = capacity * 2;
+    if (grown < kMinPointWords) {
+        grown = kMinPointWords;
+    }
+    if (grown > limit) {
+        grown = limit;
+    }
+    if (grown < need) {
+        grown = need;
+    }
+    T* bigger = new T[grown]();
+    if (keep > 0) {
+        memcpy(bigger, buf, (size_t)keep * sizeof(T));
+    }
+    delete[] buf;
+    buf = bigger;
+    capacity = grown;
+}
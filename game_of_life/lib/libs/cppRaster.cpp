@@ -0,0 +1,90 @@
+#include "cppRaster.hpp"
+#include <cmath>
+#include <cstring>
+
+int golPixelBytes(int format)
+{
+    return format == kPixelFormatGray8 ? 1 : 4;
+}
+
+// Cell index of a pixel centre along one axis, or -1 off the grid.
+static int cellAt(int p, double offset, double pixelsPerCell, int n)
+{
+    const double cell = std::floor((p + 0.5 - offset) / pixelsPerCell);
+    return (cell >= 0 && cell < n) ? (int)cell : -1;
+}
+
+void golRasterColumns(const GolRaster& raster, int cols, int32_t* columns)
+{
+    const double pixelsPerCell = raster.cellPixels * raster.zoom;
+    for (int px = 0; px < raster.width; px++) {
+        columns[px] = cellAt(px, raster.offsetX, pixelsPerCell, cols);
+    }
+}
+
+int golRasterRow(const GolRaster& raster, int rows, int py)
+{
+    return cellAt(py, raster.offsetY, raster.cellPixels * raster.zoom, rows);
+}
+
+// 0xAARRGGBB as the R G B A bytes of a kPixelFormatRgba8 pixel.
+static uint32_t rgbaPixel(uint32_t color)
+{
+    const uint8_t bytes[4] = {(uint8_t)(color >> 16), (uint8_t)(color >> 8), (uint8_t)color, (uint8_t)(color >> 24)};
+    uint32_t pixel;
+    memcpy(&pixel, bytes, sizeof(pixel));
+    return pixel;
+}
+
+static uint8_t grayPixel(uint32_t color)
+{
+    const uint32_t r = (color >> 16) & 0xFF;
+    const uint32_t g = (color >> 8) & 0xFF;
+    const uint32_t b = color & 0xFF;
+    return (uint8_t)((r * 77 + g * 150 + b * 29) >> 8);
+}
+
+void golRasterizeRow(const GolRaster& raster, const int32_t* columns, const uint8_t* cells, int py)
+{
+    const int width = raster.width;
+    if (raster.format == kPixelFormatGray8) {
+        const uint8_t colors[2] = {grayPixel(raster.deadColor), grayPixel(raster.aliveColor)};
+        uint8_t* out = raster.pixels + (size_t)py * width;
+        if (!cells) {
+            memset(out, colors[0], width);
+            return;
+        }
+        for (int px = 0; px < width; px++) {
+            out[px] = colors[columns[px] >= 0 && cells[columns[px]]];
+        }
+        return;
+    }
+
+    const uint32_t colors[2] = {rgbaPixel(raster.deadColor), rgbaPixel(raster.aliveColor)};
+    uint8_t* out = raster.pixels + (size_t)py * width * 4;
+    if (!cells) {
+        for (int px = 0; px < width; px++) {
+            memcpy(out + px * 4, &colors[0], 4);
+        }
+        return;
+    }
+    for (int px = 0; px < width; px++) {
+        memcpy(out + px * 4, &colors[columns[px] >= 0 && cells[columns[px]]], 4);
+    }
+}
+
+void golRasterizeRows(const GolRaster& raster, const int32_t* columns, const uint8_t* cells, int rows, int stride,
+                      int py0, int py1)
+{
+    const size_t rowBytes = (size_t)raster.width * golPixelBytes(raster.format);
+    int lastRow = -2;
+    for (int py = py0; py < py1; py++) {
+        const int y = golRasterRow(raster, rows, py);
+        if (y == lastRow) {
+            memcpy(raster.pixels + (size_t)py * rowBytes, raster.pixels + (size_t)(py - 1) * rowBytes, rowBytes);
+            continue;
+        }
+        golRasterizeRow(raster, columns, y >= 0 ? cells + (size_t)y * stride : nullptr, py);
+        lastRow = y;
+    }
+}
@@ -0,0 +1,50 @@
+//
+#pragma once
+#include <cstdint>
+
+// Layouts of the pixel buffers engines can draw into.
+enum GolPixelFormat
+{
+    kPixelFormatRgba8 = 0,  // 4 bytes per pixel, R G B A, as ui.PixelFormat.rgba8888
+    kPixelFormatGray8 = 1,  // 1 byte per pixel, the colour's luminance
+};
+
+// A caller-owned pixel buffer and how the grid maps onto it. Cell (x, y)
+// covers the scene rectangle from (x, y) * cellPixels to (x + 1, y + 1) *
+// cellPixels, and a scene point s lands on pixel s * zoom + offset, the
+// same transform as a Flutter canvas scaled by zoom and translated by
+// offset. Pixels are sampled at their centres; anything off the grid gets
+// deadColor.
+struct GolRaster
+{
+    uint8_t* pixels;
+    int width;
+    int height;
+    int format;           // GolPixelFormat; rows are width pixels, unpadded
+    double cellPixels;
+    double zoom;
+    double offsetX;
+    double offsetY;
+    uint32_t aliveColor;  // 0xAARRGGBB, as Flutter's Color.value
+    uint32_t deadColor;
+};
+
+// Bytes per pixel of a GolPixelFormat.
+int golPixelBytes(int format);
+
+// Fills columns[0..width) with the grid column each pixel column shows,
+// or -1 where it is off a grid cols wide.
+void golRasterColumns(const GolRaster& raster, int cols, int32_t* columns);
+
+// The grid row pixel row py shows, or -1 where it is off a grid rows tall.
+int golRasterRow(const GolRaster& raster, int rows, int py);
+
+// Draws pixel row py from cells, the grid row it shows (column 0 first),
+// or as all dead when cells is null. columns comes from golRasterColumns.
+void golRasterizeRow(const GolRaster& raster, const int32_t* columns, const uint8_t* cells, int py);
+
+// Draws pixel rows [py0, py1) from a rows x cols grid whose rows start
+// stride bytes apart. Pixel rows that show the same grid row as the one
+// above are copied from it.
+void golRasterizeRows(const GolRaster& raster, const int32_t* columns, const uint8_t* cells, int rows, int stride,
+                      int py0, int py1);
@@ -0,0 +1,173 @@
+#include "cppRunner.hpp"
+#include "cppPoints.hpp"
+#include "cppDensity.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+// Set in m_latest when the runner has published a frame the reader has
+// not picked up yet.
+static const uint32_t kFresh = 4;
+static const uint32_t kIndexMask = 3;
+
+CppRunner::CppRunner(int64_t maxPoints, UpdateFn update)
+    : m_update(std::move(update)), m_maxPoints(maxPoints)
+{
+    for (Frame& frame : m_frames) {
+        golReservePoints(frame.locs, frame.capacity, 1, 0, frameLimit());
+    }
+    m_pMutex = new std::mutex();
+    m_pWakeCv = new std::condition_variable();
+}
+
+CppRunner::~CppRunner()
+{
+    stop();
+    for (Frame& frame : m_frames) {
+        delete[] frame.locs;
+    }
+    delete (std::mutex*)m_pMutex;
+    delete (std::condition_variable*)m_pWakeCv;
+}
+
+void CppRunner::start(double gensPerSecond, uint64_t generation)
+{
+    if (m_pThread) {
+        setTargetRate(gensPerSecond);
+        return;
+    }
+    m_generation = generation;
+    m_rate.store(gensPerSecond);
+    m_stopping.store(false);
+    m_pThread = new std::thread(&CppRunner::run, this);
+}
+
+void CppRunner::stop()
+{
+    if (!m_pThread) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(*(std::mutex*)m_pMutex);
+        m_stopping.store(true);
+    }
+    ((std::condition_variable*)m_pWakeCv)->notify_one();
+    std::thread* thread = (std::thread*)m_pThread;
+    thread->join();
+    delete thread;
+    m_pThread = nullptr;
+}
+
+void CppRunner::setTargetRate(double gensPerSecond)
+{
+    {
+        std::lock_guard<std::mutex> lock(*(std::mutex*)m_pMutex);
+        m_rate.store(gensPerSecond);
+    }
+    ((std::condition_variable*)m_pWakeCv)->notify_one();
+}
+
+float* CppRunner::latest(int64_t* count, int32_t* pointFloats, int32_t* lod, uint64_t* generation)
+{
+    if (m_latest.load(std::memory_order_acquire) & kFresh) {
+        m_front = m_latest.exchange(m_front, std::memory_order_acq_rel) & kIndexMask;
+    }
+    const Frame& frame = m_frames[m_front];
+    if (count) {
+        *count = frame.count;
+    }
+    if (pointFloats) {
+        *pointFloats = frame.pointFloats;
+    }
+    if (lod) {
+        *lod = frame.lod;
+    }
+    if (generation) {
+        *generation = frame.generation;
+    }
+    return frame.locs;
+}
+
+float* CppRunner::emptyFrame(int64_t* count, int32_t* pointFloats, int32_t* lod, uint64_t* generation)
+{
+    static float empty[kDensityPointFloats] = {};
+    if (count) {
+        *count = 0;
+    }
+    if (pointFloats) {
+        *pointFloats = 2;
+    }
+    if (lod) {
+        *lod = 0;
+    }
+    if (generation) {
+        *generation = 0;
+    }
+    return empty;
+}
+
+// Copies the engine's output into the back buffer and swaps it with the
+// latest one. Only the stale tail of the back buffer is cleared, as in the
+// engines' own output. The back buffer belongs to the runner alone, so it
+// can grow here without moving a frame the reader holds.
+void CppRunner::publish(const float* locs, int64_t count, int32_t pointFloats, int32_t lod)
+{
+    Frame& frame = m_frames[m_back];
+    const int64_t floats = count * pointFloats;
+    const int64_t lastFloats = frame.count * frame.pointFloats;
+    golReservePoints(frame.locs, frame.capacity, floats + pointFloats, 0, frameLimit());
+    memcpy(frame.locs, locs, floats * sizeof(float));
+    if (floats < lastFloats) {
+        memset(frame.locs + floats, 0, (lastFloats - floats) * sizeof(float));
+    }
+    frame.count = count;
+    frame.pointFloats = pointFloats;
+    frame.lod = lod;
+    frame.generation = m_generation;
+    m_back = m_latest.exchange(m_back | kFresh, std::memory_order_acq_rel) & kIndexMask;
+}
+
+// Room for a weighted point per cell, and its terminator.
+int64_t CppRunner::frameLimit() const
+{
+    return m_maxPoints * 3 + 3;
+}
+
+void CppRunner::run()
+{
+    using Clock = std::chrono::steady_clock;
+    std::mutex& mutex = *(std::mutex*)m_pMutex;
+    std::condition_variable& wakeCv = *(std::condition_variable*)m_pWakeCv;
+    Clock::time_point next = Clock::now();
+
+    while (!m_stopping.load()) {
+        int64_t count = 0;
+        int32_t pointFloats = 2;
+        int32_t lod = 0;
+        const float* locs = m_update(&count, &pointFloats, &lod);
+        m_generation++;
+        publish(locs, count, pointFloats, lod);
+
+        const double rate = m_rate.load();
+        if (rate <= 0) {
+            continue;
+        }
+        // Pace against a fixed schedule so the rate holds on average, but
+        // never try to catch up on more than one late generation
+        const Clock::time_point now = Clock::now();
+        next += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+        if (next < now) {
+            next = now;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        const bool woken = wakeCv.wait_until(lock, next, [&] {
+            return m_stopping.load() || m_rate.load() != rate;
+        });
+        if (woken) {
+            next = Clock::now();
+        }
+    }
+}
@@ -0,0 +1,76 @@
+//
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <functional>
+
+// Runs an engine on a background thread and hands its frames to one reader
+// without blocking either side. Frames go through three buffers: the
+// runner writes the back one, the reader holds the front one, and the
+// third is the latest complete frame, swapped in with a single atomic
+// exchange on each side.
+//
+// While the runner is started it is the only caller of the engine; the
+// owner must not touch the engine again until stop() returns.
+class CppRunner
+{
+public:
+    // Advances one generation and returns the engine's output buffer,
+    // writing its number of points to count, the 32-bit words per point
+    // (2, 1 for packed cells, or kDensityPointFloats for density output) to
+    // pointFloats and its density level (0 for per-cell output) to lod.
+    // Frames are copied as raw words and keep the layout they were made
+    // with.
+    using UpdateFn = std::function<const float*(int64_t* count, int32_t* pointFloats, int32_t* lod)>;
+
+    // maxPoints is the grid's cell count, which bounds every kind of
+    // output. Frames start small and grow with the population.
+    CppRunner(int64_t maxPoints, UpdateFn update);
+    ~CppRunner();
+
+    // gensPerSecond <= 0 runs as fast as the engine allows. generation is
+    // the number the engine's current state is counted as; frames carry
+    // it on from there. Calling start while running only changes the rate.
+    void start(double gensPerSecond, uint64_t generation = 0);
+    void stop();
+    void setTargetRate(double gensPerSecond);
+    bool running() const { return m_pThread != nullptr; }
+
+    // The newest complete frame, or an empty one before the first, with
+    // its layout as UpdateFn reported it and the generation it shows. Any
+    // of the out-params may be null. The buffer stays valid, and
+    // unchanged, until the next call. Must only be called from one thread.
+    float* latest(int64_t* count, int32_t* pointFloats, int32_t* lod, uint64_t* generation);
+
+    // Fills the same out-params for an empty frame of generation 0 and
+    // returns its zero terminated buffer, for callers without a runner yet.
+    static float* emptyFrame(int64_t* count, int32_t* pointFloats, int32_t* lod, uint64_t* generation);
+
+private:
+    struct Frame
+    {
+        float* locs = nullptr;  // Zero terminated like the engines' output
+        int64_t capacity = 0;   // Floats allocated for locs
+        int64_t count = 0;
+        int32_t pointFloats = 2;
+        int32_t lod = 0;
+        uint64_t generation = 0;
+    };
+
+    void run();
+    void publish(const float* locs, int64_t count, int32_t pointFloats, int32_t lod);
+    int64_t frameLimit() const;
+
+    UpdateFn m_update;
+    int64_t m_maxPoints = 0;
+    Frame m_frames[3];
+    int m_back = 0;                  // Runner side
+    int m_front = 2;                 // Reader side
+    std::atomic<uint32_t> m_latest{1};  // Index of the third buffer | kFresh
+    std::atomic<double> m_rate{0};
+    std::atomic<bool> m_stopping{false};
+    uint64_t m_generation = 0;
+    void* m_pThread = nullptr;  // (std::thread*)
+    void* m_pMutex;             // (std::mutex*) guards the pacing wait
+    void* m_pWakeCv;            // (std::condition_variable*) cuts the wait short
+};
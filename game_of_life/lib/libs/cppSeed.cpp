@@ -0,0 +1,58 @@
+#include "cppSeed.hpp"
+#include <random>
+
+void golSeedSoup(uint8_t* cells, int rows, int cols, int stride, uint32_t seed, double density)
+{
+    // mt19937 output is fixed by the standard; the distributions are not
+    std::mt19937 gen(seed);
+    const double clamped = density < 0 ? 0 : (density > 1 ? 1 : density);
+    const uint64_t threshold = (uint64_t)(clamped * 4294967296.0);
+    for (int y = 0; y < rows; y++) {
+        uint8_t* row = cells + (int64_t)y * stride;
+        for (int x = 0; x < cols; x++) {
+            row[x] = gen() < threshold;
+        }
+    }
+}
+
+void golImportRow(uint8_t* dst, const void* src, int format, int cols, int y)
+{
+    switch (format) {
+    case kCellFormatBits: {
+        const uint8_t* row = (const uint8_t*)src + (int64_t)y * ((cols + 7) / 8);
+        for (int x = 0; x < cols; x++) {
+            dst[x] = (row[x >> 3] >> (x & 7)) & 1;
+        }
+        break;
+    }
+    case kCellFormatFloats: {
+        const float* row = (const float*)src + (int64_t)y * cols;
+        for (int x = 0; x < cols; x++) {
+            dst[x] = row[x] != 0.0f;
+        }
+        break;
+    }
+    default: {
+        const uint8_t* row = (const uint8_t*)src + (int64_t)y * cols;
+        for (int x = 0; x < cols; x++) {
+            dst[x] = row[x] != 0;
+        }
+        break;
+    }
+    }
+}
+
+void golImportCells(uint8_t* cells, int rows, int cols, int stride, const void* src, int format)
+{
+    for (int y = 0; y < rows; y++) {
+        golImportRow(cells + (int64_t)y * stride, src, format, cols, y);
+    }
+}
+
+uint8_t golEditedCell(uint8_t alive, uint8_t edit)
+{
+    if (edit == kEditToggle) {
+        return !alive;
+    }
+    return edit != kEditDead;
+}
@@ -0,0 +1,38 @@
+//
+#pragma once
+#include <cstdint>
+
+// Fills a rows x cols block of cells, whose rows start stride bytes apart,
+// with a random soup: each cell is alive with probability density. The
+// same seed gives the same soup on every platform, which srand/rand do not
+// guarantee, so benchmark runs stay comparable.
+void golSeedSoup(uint8_t* cells, int rows, int cols, int stride, uint32_t seed, double density);
+
+// Layouts an external cell buffer may come in, all rows * cols cells in
+// row-major order with any non-zero value meaning alive.
+enum GolCellFormat
+{
+    kCellFormatBytes = 0,   // One uint8_t per cell
+    kCellFormatBits = 1,    // One bit per cell, LSB first; rows padded to whole bytes
+    kCellFormatFloats = 2,  // One float per cell, as in the Dart InputGrid
+};
+
+// Converts row y of src (cols cells wide, in the given GolCellFormat) to
+// one 0/1 byte per cell in dst.
+void golImportRow(uint8_t* dst, const void* src, int format, int cols, int y);
+
+// Converts all of src into a rows x cols block of 0/1 bytes whose rows
+// start stride bytes apart, in a single pass over the source.
+void golImportCells(uint8_t* cells, int rows, int cols, int stride, const void* src, int format);
+
+// Per-cell values of the states array taken by the applyEdits calls.
+enum GolEdit
+{
+    kEditDead = 0,
+    kEditAlive = 1,
+    kEditToggle = 2,
+};
+
+// The 0/1 state a cell in state alive ends up in after edit (a GolEdit;
+// any other non-zero value counts as kEditAlive).
+uint8_t golEditedCell(uint8_t alive, uint8_t edit);
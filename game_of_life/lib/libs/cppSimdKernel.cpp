@@ -0,0 +1,292 @@
+#include "cppSimdKernel.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GOL_X86 1
+#endif
+
+namespace {
+
+typedef void (*StepRowFn)(const uint8_t*, const uint8_t*, const uint8_t*, uint8_t*, int);
+typedef int64_t (*CollectRowFn)(const uint8_t*, int, int, int, float, float*, int64_t);
+typedef int64_t (*CollectCellsRowFn)(const uint8_t*, int, int, int, uint32_t*, int64_t);
+
+void stepRowScalar(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint8_t* out, int n)
+{
+    for (int x = 0; x < n; x++) {
+        int neighbors =
+            above[x - 1] + above[x] + above[x + 1] +
+            row[x - 1] +              row[x + 1] +
+            below[x - 1] + below[x] + below[x + 1];
+        out[x] = (neighbors == 3) | (row[x] & (neighbors == 2));
+    }
+}
+
+int64_t collectRowScalar(const uint8_t* row, int n, int x0, int y, float cellSize, float* out, int64_t k)
+{
+    const float halfCell = cellSize * 0.5f;
+    const float fy = y * cellSize + halfCell;
+    for (int x = 0; x < n; x++) {
+        if (row[x]) {
+            out[k++] = (x0 + x) * cellSize + halfCell;
+            out[k++] = fy;
+        }
+    }
+    return k;
+}
+
+int64_t collectCellsRowScalar(const uint8_t* row, int n, int x0, int y, uint32_t* out, int64_t k)
+{
+    const uint32_t packedY = (uint32_t)y << 16;
+    for (int x = 0; x < n; x++) {
+        if (row[x]) {
+            out[k++] = packedY | (uint32_t)(x0 + x);
+        }
+    }
+    return k;
+}
+
+#ifdef GOL_X86
+
+__attribute__((target("avx2")))
+void stepRowAvx2(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint8_t* out, int n)
+{
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i two = _mm256_set1_epi8(2);
+    const __m256i three = _mm256_set1_epi8(3);
+    int x = 0;
+    for (; x + 32 <= n; x += 32) {
+        __m256i sum = _mm256_loadu_si256((const __m256i*)(above + x - 1));
+        sum = _mm256_add_epi8(sum, _mm256_loadu_si256((const __m256i*)(above + x)));
+        sum = _mm256_add_epi8(sum, _mm256_loadu_si256((const __m256i*)(above + x + 1)));
+        sum = _mm256_add_epi8(sum, _mm256_loadu_si256((const __m256i*)(row + x - 1)));
+        sum = _mm256_add_epi8(sum, _mm256_loadu_si256((const __m256i*)(row + x + 1)));
+        sum = _mm256_add_epi8(sum, _mm256_loadu_si256((const __m256i*)(below + x - 1)));
+        sum = _mm256_add_epi8(sum, _mm256_loadu_si256((const __m256i*)(below + x)));
+        sum = _mm256_add_epi8(sum, _mm256_loadu_si256((const __m256i*)(below + x + 1)));
+
+        __m256i cur = _mm256_loadu_si256((const __m256i*)(row + x));
+        __m256i born = _mm256_cmpeq_epi8(sum, three);
+        __m256i stay = _mm256_and_si256(_mm256_cmpeq_epi8(sum, two), _mm256_cmpeq_epi8(cur, one));
+        __m256i next = _mm256_and_si256(_mm256_or_si256(born, stay), one);
+        _mm256_storeu_si256((__m256i*)(out + x), next);
+    }
+    stepRowScalar(above + x, row + x, below + x, out + x, n - x);
+}
+
+__attribute__((target("avx2")))
+int64_t collectRowAvx2(const uint8_t* row, int n, int x0, int y, float cellSize, float* out, int64_t k)
+{
+    const float halfCell = cellSize * 0.5f;
+    const float fy = y * cellSize + halfCell;
+    const __m256i zero = _mm256_setzero_si256();
+    int x = 0;
+    for (; x + 32 <= n; x += 32) {
+        __m256i cells = _mm256_loadu_si256((const __m256i*)(row + x));
+        uint32_t live = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(cells, zero));
+        while (live) {
+            int bit = __builtin_ctz(live);
+            live &= live - 1;
+            out[k++] = (x0 + x + bit) * cellSize + halfCell;
+            out[k++] = fy;
+        }
+    }
+    return collectRowScalar(row + x, n - x, x0 + x, y, cellSize, out, k);
+}
+
+__attribute__((target("avx2")))
+int64_t collectCellsRowAvx2(const uint8_t* row, int n, int x0, int y, uint32_t* out, int64_t k)
+{
+    const uint32_t packedY = (uint32_t)y << 16;
+    const __m256i zero = _mm256_setzero_si256();
+    int x = 0;
+    for (; x + 32 <= n; x += 32) {
+        __m256i cells = _mm256_loadu_si256((const __m256i*)(row + x));
+        uint32_t live = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(cells, zero));
+        while (live) {
+            int bit = __builtin_ctz(live);
+            live &= live - 1;
+            out[k++] = packedY | (uint32_t)(x0 + x + bit);
+        }
+    }
+    return collectCellsRowScalar(row + x, n - x, x0 + x, y, out, k);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+void stepRowAvx512(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint8_t* out, int n)
+{
+    const __m512i one = _mm512_set1_epi8(1);
+    const __m512i two = _mm512_set1_epi8(2);
+    const __m512i three = _mm512_set1_epi8(3);
+    int x = 0;
+    for (; x + 64 <= n; x += 64) {
+        __m512i sum = _mm512_loadu_si512(above + x - 1);
+        sum = _mm512_add_epi8(sum, _mm512_loadu_si512(above + x));
+        sum = _mm512_add_epi8(sum, _mm512_loadu_si512(above + x + 1));
+        sum = _mm512_add_epi8(sum, _mm512_loadu_si512(row + x - 1));
+        sum = _mm512_add_epi8(sum, _mm512_loadu_si512(row + x + 1));
+        sum = _mm512_add_epi8(sum, _mm512_loadu_si512(below + x - 1));
+        sum = _mm512_add_epi8(sum, _mm512_loadu_si512(below + x));
+        sum = _mm512_add_epi8(sum, _mm512_loadu_si512(below + x + 1));
+
+        __m512i cur = _mm512_loadu_si512(row + x);
+        __mmask64 born = _mm512_cmpeq_epi8_mask(sum, three);
+        __mmask64 stay = _mm512_cmpeq_epi8_mask(sum, two) & _mm512_test_epi8_mask(cur, one);
+        _mm512_storeu_si512(out + x, _mm512_maskz_mov_epi8(born | stay, one));
+    }
+    stepRowAvx2(above + x, row + x, below + x, out + x, n - x);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+int64_t collectRowAvx512(const uint8_t* row, int n, int x0, int y, float cellSize, float* out, int64_t k)
+{
+    const float halfCell = cellSize * 0.5f;
+    const float fy = y * cellSize + halfCell;
+    int x = 0;
+    for (; x + 64 <= n; x += 64) {
+        __m512i cells = _mm512_loadu_si512(row + x);
+        uint64_t live = _mm512_test_epi8_mask(cells, cells);
+        while (live) {
+            int bit = __builtin_ctzll(live);
+            live &= live - 1;
+            out[k++] = (x0 + x + bit) * cellSize + halfCell;
+            out[k++] = fy;
+        }
+    }
+    return collectRowAvx2(row + x, n - x, x0 + x, y, cellSize, out, k);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+int64_t collectCellsRowAvx512(const uint8_t* row, int n, int x0, int y, uint32_t* out, int64_t k)
+{
+    const uint32_t packedY = (uint32_t)y << 16;
+    int x = 0;
+    for (; x + 64 <= n; x += 64) {
+        __m512i cells = _mm512_loadu_si512(row + x);
+        uint64_t live = _mm512_test_epi8_mask(cells, cells);
+        while (live) {
+            int bit = __builtin_ctzll(live);
+            live &= live - 1;
+            out[k++] = packedY | (uint32_t)(x0 + x + bit);
+        }
+    }
+    return collectCellsRowAvx2(row + x, n - x, x0 + x, y, out, k);
+}
+
+#endif
+
+struct Dispatch {
+    StepRowFn step = stepRowScalar;
+    CollectRowFn collect = collectRowScalar;
+    CollectCellsRowFn collectCells = collectCellsRowScalar;
+    const char* name = "scalar";
+
+    Dispatch() {
+#ifdef GOL_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512bw")) {
+            step = stepRowAvx512;
+            collect = collectRowAvx512;
+            collectCells = collectCellsRowAvx512;
+            name = "avx512bw";
+        } else if (__builtin_cpu_supports("avx2")) {
+            step = stepRowAvx2;
+            collect = collectRowAvx2;
+            collectCells = collectCellsRowAvx2;
+            name = "avx2";
+        }
+#endif
+    }
+};
+
+const Dispatch& dispatch()
+{
+    static const Dispatch d;
+    return d;
+}
+
+}
+
+void golStepRow(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint8_t* out, int n)
+{
+    dispatch().step(above, row, below, out, n);
+}
+
+int64_t golCollectRow(const uint8_t* row, int n, int x0, int y, float cellSize, float* out, int64_t k)
+{
+    return dispatch().collect(row, n, x0, y, cellSize, out, k);
+}
+
+int64_t golCollectCellsRow(const uint8_t* row, int n, int x0, int y, uint32_t* out, int64_t k)
+{
+    return dispatch().collectCells(row, n, x0, y, out, k);
+}
+
+int golCountRow(const uint8_t* row, int n)
+{
+    // Simple enough for the compiler to vectorize on every target
+    int count = 0;
+    for (int x = 0; x < n; x++) {
+        count += row[x];
+    }
+    return count;
+}
+
+void golCountDeltaRow(const uint8_t* prev, const uint8_t* next, int n, int64_t* born, int64_t* died)
+{
+    int b = 0;
+    int d = 0;
+    for (int x = 0; x < n; x++) {
+        b += next[x] & (prev[x] ^ 1);
+        d += prev[x] & (next[x] ^ 1);
+    }
+    *born += b;
+    *died += d;
+}
+
+void golCollectDeltaRow(const uint8_t* prev, const uint8_t* next, int n, int x0, int y, float cellSize,
+                        float* born, int64_t* bornK, float* died, int64_t* diedK)
+{
+    const float halfCell = cellSize * 0.5f;
+    const float fy = y * cellSize + halfCell;
+    // Indexed by the cell's new state, so the list is picked without a
+    // branch; births and deaths interleave too randomly to predict
+    float* const lists[2] = {died, born};
+    int64_t ks[2] = {*diedK, *bornK};
+    int x = 0;
+    // Cells are 0 or 1, so in the XOR of eight of them each changed cell
+    // is a single set bit at the bottom of its byte
+    for (; x + 8 <= n; x += 8) {
+        uint64_t a;
+        uint64_t b;
+        memcpy(&a, prev + x, sizeof(a));
+        memcpy(&b, next + x, sizeof(b));
+        uint64_t changed = a ^ b;
+        while (changed) {
+            const int i = x + (__builtin_ctzll(changed) >> 3);
+            const int alive = next[i];
+            float* out = lists[alive] + ks[alive];
+            out[0] = (x0 + i) * cellSize + halfCell;
+            out[1] = fy;
+            ks[alive] += 2;
+            changed &= changed - 1;
+        }
+    }
+    for (; x < n; x++) {
+        if (prev[x] != next[x]) {
+            const int alive = next[x];
+            float* out = lists[alive] + ks[alive];
+            out[0] = (x0 + x) * cellSize + halfCell;
+            out[1] = fy;
+            ks[alive] += 2;
+        }
+    }
+    *bornK = ks[1];
+    *diedK = ks[0];
+}
+
+const char* golKernelName()
+{
+    return dispatch().name;
+}
@@ -0,0 +1,37 @@
+//
+#pragma once
+#include <cstdint>
+
+// Row kernels shared by the byte-per-cell engines. Cells are 0 or 1.
+// The implementation (AVX-512BW, AVX2 or scalar) is picked once at load
+// time from the running CPU.
+
+// Writes the next state of row[0..n) into out[0..n). row[-1] and row[n]
+// (and the same columns of above/below) must be readable.
+void golStepRow(const uint8_t* above, const uint8_t* row, const uint8_t* below, uint8_t* out, int n);
+
+// Appends "x, y" centre coordinates of the live cells in row[0..n) to
+// out starting at index k, where row[0] is column x0. Returns the new k.
+int64_t golCollectRow(const uint8_t* row, int n, int x0, int y, float cellSize, float* out, int64_t k);
+
+// Appends the live cells of row[0..n) to out from index k as packed
+// kPointFormatCells words, x | y << 16 (see cppPoints.hpp), where row[0]
+// is column x0. Returns the new k.
+int64_t golCollectCellsRow(const uint8_t* row, int n, int x0, int y, uint32_t* out, int64_t k);
+
+// Number of live cells in row[0..n).
+int golCountRow(const uint8_t* row, int n);
+
+// Adds the cells of row[0..n) that came alive between prev and next to
+// born and those that died to died.
+void golCountDeltaRow(const uint8_t* prev, const uint8_t* next, int n, int64_t* born, int64_t* died);
+
+// Appends "x, y" centre coordinates of the cells that came alive between
+// prev[0..n) and next[0..n) to born from index *bornK, and of those that
+// died to died from *diedK, like golCollectRow. Unchanged stretches are
+// skipped eight cells at a time.
+void golCollectDeltaRow(const uint8_t* prev, const uint8_t* next, int n, int x0, int y, float cellSize,
+                        float* born, int64_t* bornK, float* died, int64_t* diedK);
+
+// Name of the selected implementation, for logging.
+const char* golKernelName();
@@ -0,0 +1,8 @@
+#include "cppStats.hpp"
+#include <chrono>
+
+uint64_t golNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
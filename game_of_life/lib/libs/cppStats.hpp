@@ -0,0 +1,21 @@
+//
+#pragma once
+#include <cstdint>
+
+// Time spent per phase of an engine's frames, accumulated since the last
+// reset. Read through getStatsXxx exports, so the layout is part of the C
+// ABI (see lib/data/gol_stats.dart); only append fields.
+struct GolStats
+{
+    uint64_t frames;     // Frames that produced output
+    uint64_t totalNs;    // Wall time of those frames and of output-less steps
+    uint64_t clearNs;    // Zeroing stale output
+    uint64_t borderNs;   // Ghost frame refresh
+    uint64_t stepNs;     // Neighbour counting and the rule
+    uint64_t collectNs;  // Writing live cells to the output
+    uint64_t syncNs;     // Waking workers and waiting for the slowest one
+    uint64_t mergeNs;    // Combining per-worker results
+};
+
+// Monotonic clock in nanoseconds, for the counters above.
+uint64_t golNowNs();
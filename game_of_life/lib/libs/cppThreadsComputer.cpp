@@ -1,149 +1,718 @@
 #include "cppThreadsComputer.hpp"
+#include "cppSimdKernel.hpp"
+#include "cppBoundary.hpp"
+#include "cppSeed.hpp"
+#include "cppViewport.hpp"
+#include "cppDensity.hpp"
+#include "cppRaster.hpp"
+#include "cppPoints.hpp"
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <vector>
 #include <ctime>   // For time()
 #include <cstdlib> // For rand() and srand()
 #include <atomic>
-#include <iostream>
+#include <cstring>
 
-CppThreadsComputer::CppThreadsComputer(int32_t nRows, int32_t nCols, double cellSize)
-: rows(nRows), cols(nCols), cellSize(cellSize), m_numThreads(std::thread::hardware_concurrency()*2)
+// Yields to spin through before a worker (or update()) parks on its
+// condition variable; back-to-back generations then never hit the futex.
+static const int kSpinIterations = 2000;
+
+// Default height of a tile. Tiles span the full grid width, so a tile is a
+// band of rows that is contiguous in memory and in the output order.
+static const int kDefaultTileRows = 16;
+
+// Work handed to the pool by runTask. The live cells are compacted in two
+// passes: workers count the rows of their tiles, the counts are scanned
+// into offsets, then every worker writes its cells straight into
+// m_pAliveLocs.
+enum ThreadTask
 {
-    std::cout << "Using " << m_numThreads << " threads." << std::endl;
+    kTaskStep,       // Step the tile into m_pNewGrid
+    kTaskStepCount,  // Step the tile and count its live cells
+    kTaskCount,      // Count the live cells of the tile in m_pGrid
+    kTaskCollect,    // Write the tile's cells of m_pGrid at its offset
+    kTaskRaster,     // Draw the tile's share of m_pRaster's pixel rows
+    kTaskStepDelta,  // Step the tile and count the cells born and died in it
+    kTaskCollectDelta,  // Write the tile's born and died cells at its offsets
+};
 
-    //sleep 500 ms
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));    
-    
-    initData();
+static bool isStepTask(int task)
+{
+    return task == kTaskStep || task == kTaskStepCount || task == kTaskStepDelta;
+}
+
+// Each worker starts a task with an even share of the tiles as a range
+// [front, back) packed into one atomic word. The owner pops from the
+// front and idle workers steal from the back, both with a CAS, so a worker
+// stuck on dense tiles hands the rest of its range to the others.
+struct alignas(64) WorkerSlot
+{
+    std::atomic<uint64_t> range{0};
+    uint64_t busyNs = 0;   // Time spent on stepping tasks since the last reset
+    uint64_t lastNs = 0;   // Time spent on the last task
+    int stolen = 0;        // Tiles taken from other workers since the last reset
+};
+
+static uint64_t packRange(uint32_t front, uint32_t back)
+{
+    return ((uint64_t)back << 32) | front;
+}
+
+// numThreads <= 0 picks twice the hardware concurrency.
+CppThreadsComputer::CppThreadsComputer(int32_t nRows, int32_t nCols, double cellSize, int numThreads, const void* cells, int format)
+: rows(nRows), cols(nCols), cellSize(cellSize), m_numThreads(numThreads > 0 ? numThreads : std::thread::hardware_concurrency()*2)
+{
+    stride = cols + 2;
+    m_view = golFullViewport(rows, cols);
+    initData(cells, format);
     m_pMutex = (void*) new std::mutex();
-    m_pThreadsList = (void*) new std::vector<std::thread>(m_numThreads);
+    m_pWorkCv = (void*) new std::condition_variable();
+    m_pDoneCv = (void*) new std::condition_variable();
+    m_pThreadsList = (void*) new std::vector<std::thread>();
+    m_pSlots = new WorkerSlot[m_numThreads];
+    m_pTileCounts = nullptr;
+    m_pTileOffsets = nullptr;
+    m_pTileDied = nullptr;
+    m_pTileDiedOffsets = nullptr;
+    setTileRows(kDefaultTileRows);
     
     // Pre-allocate grid to avoid allocation on each update
-    m_pNewGrid = new uint8_t[rows * cols];
+    m_pNewGrid = new uint8_t[(rows + 2) * stride]();
+
+    startWorkers();
 }
 
 CppThreadsComputer::~CppThreadsComputer()
 {
+    stopWorkers();
     delete[] m_pGrid;
     delete[] m_pNewGrid;
     delete[] m_pAliveLocs;
+    delete[] m_pAliveCells;
+    delete[] m_pDensity;
+    delete[] m_pTileDensity;
+    delete[] m_pTileSums;
+    delete[] m_pRasterColumns;
+    delete[] m_pTileCounts;
+    delete[] m_pTileOffsets;
+    delete[] m_pTileDied;
+    delete[] m_pTileDiedOffsets;
+    delete[] m_pBorn;
+    delete[] m_pDied;
+    delete[] m_pSlots;
     delete (std::mutex*)m_pMutex;
+    delete (std::condition_variable*)m_pWorkCv;
+    delete (std::condition_variable*)m_pDoneCv;
     delete (std::vector<std::thread>*)m_pThreadsList;
 }
 
-void CppThreadsComputer::initData()
+void CppThreadsComputer::startWorkers()
 {
-    m_pGrid = new uint8_t[rows * cols];
-    populateInputGridWithBools();
-    m_pAliveLocs = new float[rows * cols * 2];
+    std::vector<std::thread>* threads = (std::vector<std::thread>*)m_pThreadsList;
+    threads->reserve(m_numThreads);
+    for (int t = 0; t < m_numThreads; ++t) {
+        threads->emplace_back(&CppThreadsComputer::workerLoop, this, t);
+    }
 }
 
-void CppThreadsComputer::populateInputGridWithBools()
+void CppThreadsComputer::stopWorkers()
 {
-    srand((uint8_t)7);
-    for (int i = 0; i < rows * cols; ++i)
+    std::mutex* mutex = (std::mutex*)m_pMutex;
     {
-        bool randomBool = rand() % 2;
-        m_pGrid[i] = randomBool ? 1 : 0;
+        std::lock_guard<std::mutex> lock(*mutex);
+        m_stopping.store(true);
+    }
+    ((std::condition_variable*)m_pWorkCv)->notify_all();
+
+    for (auto& th : *(std::vector<std::thread>*)m_pThreadsList) {
+        th.join();
     }
 }
 
-float* CppThreadsComputer::update(){
-    memset(m_pAliveLocs, 0, rows * cols * 2 * sizeof(float));
-    
-    // Pre-allocate per-thread buffers
-    std::vector<std::vector<std::pair<float, float>>> threadResults(m_numThreads);
-    std::vector<std::thread>* threads = (std::vector<std::thread>*)m_pThreadsList;
-    
-    int chunkSize = rows / m_numThreads;
+// Persistent worker: waits for runTask() to publish a new task, runs it on
+// its own tiles and then on stolen ones, and reports back through
+// m_pendingWorkers.
+void CppThreadsComputer::workerLoop(int t)
+{
+    std::mutex* mutex = (std::mutex*)m_pMutex;
+    std::condition_variable* workCv = (std::condition_variable*)m_pWorkCv;
+    uint64_t seen = 0;
 
-    for (int t = 0; t < m_numThreads; ++t) {
-        int startRow = t * chunkSize;
-        int endRow = (t == m_numThreads - 1) ? rows : startRow + chunkSize;
-        
-        (*threads)[t] = std::thread(&CppThreadsComputer::updateChunkLockFree, this, 
-                                   startRow, endRow, std::ref(threadResults[t]));
+    while (true) {
+        for (int i = 0; i < kSpinIterations && m_generation.load(std::memory_order_acquire) == seen
+                        && !m_stopping.load(std::memory_order_relaxed); i++) {
+            std::this_thread::yield();
+        }
+        if (m_generation.load(std::memory_order_acquire) == seen) {
+            std::unique_lock<std::mutex> lock(*mutex);
+            workCv->wait(lock, [&] {
+                return m_generation.load(std::memory_order_acquire) != seen || m_stopping.load();
+            });
+        }
+        if (m_stopping.load()) {
+            return;
+        }
+        seen = m_generation.load(std::memory_order_acquire);
+
+        const uint64_t start = golNowNs();
+        int tile;
+        while ((tile = popTile(t)) >= 0) {
+            runTile(tile);
+        }
+        while ((tile = stealTile(t)) >= 0) {
+            runTile(tile);
+            m_pSlots[t].stolen++;
+        }
+        m_pSlots[t].lastNs = golNowNs() - start;
+        if (isStepTask(m_task)) {
+            m_pSlots[t].busyNs += m_pSlots[t].lastNs;
+        }
+
+        if (m_pendingWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(*mutex);
+            ((std::condition_variable*)m_pDoneCv)->notify_one();
+        }
     }
+}
 
-    for (auto& th : *threads) {
-        th.join();
+int CppThreadsComputer::popTile(int t)
+{
+    std::atomic<uint64_t>& range = m_pSlots[t].range;
+    uint64_t r = range.load(std::memory_order_acquire);
+    while ((uint32_t)r < (uint32_t)(r >> 32)) {
+        if (range.compare_exchange_weak(r, r + 1, std::memory_order_acq_rel)) {
+            return (int)(uint32_t)r;
+        }
     }
-    
-    // Combine results without locks
-    int k = 0;
-    for (auto& result : threadResults) {
-        for (auto& cell : result) {
-            if (k + 1 < rows * cols * 2) {
-                m_pAliveLocs[k++] = cell.first;
-                m_pAliveLocs[k++] = cell.second;
+    return -1;
+}
+
+// Takes the last tile of the first non-empty range after worker t's own.
+int CppThreadsComputer::stealTile(int t)
+{
+    for (int i = 1; i < m_numThreads; i++) {
+        std::atomic<uint64_t>& range = m_pSlots[(t + i) % m_numThreads].range;
+        uint64_t r = range.load(std::memory_order_acquire);
+        while (true) {
+            uint32_t front = (uint32_t)r;
+            uint32_t back = (uint32_t)(r >> 32);
+            if (front >= back) {
+                break;
+            }
+            if (range.compare_exchange_weak(r, packRange(front, back - 1), std::memory_order_acq_rel)) {
+                return (int)(back - 1);
             }
         }
     }
+    return -1;
+}
 
-    std::swap(m_pGrid, m_pNewGrid);
-    return m_pAliveLocs;
+// Starts from cells when given, see load, and from the legacy soup
+// otherwise.
+void CppThreadsComputer::initData(const void* cells, int format)
+{
+    m_pGrid = new uint8_t[(rows + 2) * stride]();
+    if (cells) {
+        load(cells, format);
+    } else {
+        populateInputGridWithBools();
+    }
 }
 
-void CppThreadsComputer::updateChunkLockFree(int startRow, int endRow, 
-                                            std::vector<std::pair<float, float>>& result) {
-    result.clear();
-    result.reserve((endRow - startRow) * cols / 4); // Estimate
-    
-    const float halfCell = cellSize * 0.5f;
-    
-    for (int y = startRow; y < endRow; y++) {
-        for (int x = 0; x < cols; x++) {
-            int idx = y * cols + x;
-            int neighbors = (y > 0 && y < rows - 1 && x > 0 && x < cols - 1) ?
-                m_pGrid[(y-1) * cols + (x-1)] + m_pGrid[(y-1) * cols + x] + m_pGrid[(y-1) * cols + (x+1)] +
-                m_pGrid[y * cols + (x-1)] +                                   m_pGrid[y * cols + (x+1)] +
-                m_pGrid[(y+1) * cols + (x-1)] + m_pGrid[(y+1) * cols + x] + m_pGrid[(y+1) * cols + (x+1)] :
-                countNeighborsBounds(x, y);
-            
-            uint8_t alive = m_pGrid[idx];
-            uint8_t newState = alive ? 
-                ((neighbors == 2 || neighbors == 3) ? 1 : 0) : 
-                ((neighbors == 3) ? 1 : 0);
-            
-            m_pNewGrid[idx] = newState;
-            
-            if (newState) {
-                result.emplace_back(x * cellSize + halfCell, y * cellSize + halfCell);
-            }
+void CppThreadsComputer::populateInputGridWithBools()
+{
+    srand((uint8_t)7);
+    for (int y = 0; y < rows; ++y)
+    {
+        for (int x = 0; x < cols; ++x)
+        {
+            bool randomBool = rand() % 2;
+            m_pGrid[(y + 1) * stride + x + 1] = randomBool ? 1 : 0;
         }
     }
 }
 
-int32_t CppThreadsComputer::countNeighbors(int x, int y){
-    int32_t count = 0;
-    for (int i = -1; i <= 1; i++) {
-        for (int j = -1; j <= 1; j++) {
-            if (i == 0 && j == 0) continue;
-            int nx = x + i, ny = y + j;
-            if (nx >= 0 && nx < cols && ny >= 0 && ny < rows) {
-                count += m_pGrid[ny * cols + nx] == 1 ? 1 : 0;
-            }
+// Replaces the grid with a soup of the given density, see golSeedSoup.
+void CppThreadsComputer::seed(uint32_t seed, double density)
+{
+    golSeedSoup(m_pGrid + stride + 1, rows, cols, stride, seed, density);
+}
+
+// Replaces the grid with cells, rows * cols cells in the given
+// GolCellFormat.
+void CppThreadsComputer::load(const void* cells, int format)
+{
+    golImportCells(m_pGrid + stride + 1, rows, cols, stride, cells, format);
+}
+
+// Applies n edits between generations: cell (xy[2i], xy[2i+1]) takes
+// GolEdit states[i]. Cells outside the grid are ignored. The output buffer
+// is not touched until the next update or collect.
+void CppThreadsComputer::applyEdits(const int32_t* xy, const uint8_t* states, int n)
+{
+    for (int i = 0; i < n; i++) {
+        const int x = xy[2 * i];
+        const int y = xy[2 * i + 1];
+        if (x < 0 || y < 0 || x >= cols || y >= rows) {
+            continue;
         }
+        uint8_t& cell = m_pGrid[(y + 1) * stride + x + 1];
+        cell = golEditedCell(cell, states[i]);
     }
-    return count;
 }
 
-int32_t CppThreadsComputer::countNeighborsBounds(int x, int y) {
-    int32_t count = 0;
-    
-    // Optimized bounds checking
-    int startY = (y > 0) ? y - 1 : y;
-    int endY = (y < rows - 1) ? y + 1 : y;
-    int startX = (x > 0) ? x - 1 : x;
-    int endX = (x < cols - 1) ? x + 1 : x;
-    
-    for (int ny = startY; ny <= endY; ny++) {
-        for (int nx = startX; nx <= endX; nx++) {
-            if (nx == x && ny == y) continue;  // Skip center cell
-            count += m_pGrid[ny * cols + nx];
+// Limits output points to the cells in [x0, x1) x [y0, y1), clipped to
+// the grid. Takes effect from the next update or collect.
+void CppThreadsComputer::setViewport(int x0, int y0, int x1, int y1)
+{
+    m_view = golClampViewport(x0, y0, x1, y1, rows, cols);
+}
+
+// Switches the output between one point per live cell (level 0) and one
+// weighted point per 2^level x 2^level block, see cppDensity.hpp. Workers
+// sum the blocks of their tiles while stepping them, so tiles are rounded
+// up to whole blocks. Takes effect from the next update or collect.
+void CppThreadsComputer::setLod(int level)
+{
+    level = level < 0 ? 0 : (level > kMaxDensityLevel ? kMaxDensityLevel : level);
+    if (level == m_lod) {
+        return;
+    }
+    m_lod = level;
+    setTileRows(m_requestedTileRows);
+}
+
+// Switches the per-cell output between float centres and packed cell
+// coordinates, see GolPointFormat. Only the buffer of the current format
+// is kept, and regrown from scratch by the next frame. Takes effect from
+// the next update or collect; returns false, changing nothing, for an
+// unknown format or a grid too large to pack.
+bool CppThreadsComputer::setPointFormat(int format)
+{
+    if (!golPointFormatFits(format, rows, cols)) {
+        return false;
+    }
+    if (format == m_pointFormat) {
+        return true;
+    }
+    delete[] m_pAliveLocs;
+    delete[] m_pAliveCells;
+    m_pAliveLocs = nullptr;
+    m_pAliveCells = nullptr;
+    m_aliveCapacity = 0;
+    m_pointFormat = format;
+    m_aliveCount = 0;
+    return true;
+}
+
+void CppThreadsComputer::setBoundary(int mode)
+{
+    m_boundary = mode;
+}
+
+float* CppThreadsComputer::update(){
+    const uint64_t start = golNowNs();
+    runTask(kTaskStepCount);
+    std::swap(m_pGrid, m_pNewGrid);
+
+    finishOutput();
+    m_stats.totalNs += golNowNs() - start;
+    m_stats.frames++;
+    return output();
+}
+
+// Advances gens generations without touching m_pAliveLocs.
+void CppThreadsComputer::step(int gens){
+    const uint64_t start = golNowNs();
+    for (int g = 0; g < gens; g++) {
+        runTask(kTaskStep);
+        std::swap(m_pGrid, m_pNewGrid);
+    }
+    m_stats.totalNs += golNowNs() - start;
+}
+
+// Rebuilds m_pAliveLocs from the current generation.
+float* CppThreadsComputer::collect(){
+    const uint64_t start = golNowNs();
+    runTask(kTaskCount);
+    finishOutput();
+    m_stats.totalNs += golNowNs() - start;
+    m_stats.frames++;
+    return output();
+}
+
+// The buffer update and collect fill, see CppComputer::output.
+float* CppThreadsComputer::output()
+{
+    if (m_lod) {
+        return m_pDensity;
+    }
+    return m_pointFormat == kPointFormatCells ? reinterpret_cast<float*>(m_pAliveCells) : m_pAliveLocs;
+}
+
+// Advances one generation like update(), but instead of all live cells
+// lists the ones that changed: cells born go to m_pBorn and cells that
+// died to m_pDied, both limited to the viewport. Workers count the changes
+// of their tiles while stepping them and, once the counts are scanned,
+// write them by comparing the two grids. m_pAliveLocs is left as it was;
+// collect() rebuilds it, e.g. to resync after the viewport moved.
+void CppThreadsComputer::updateDeltas(){
+    const uint64_t start = golNowNs();
+    runTask(kTaskStepDelta);
+    std::swap(m_pGrid, m_pNewGrid);
+
+    uint64_t t = golNowNs();
+    int64_t born = 0;
+    int64_t died = 0;
+    for (int i = 0; i < m_numTiles; i++) {
+        m_pTileOffsets[i] = born * 2;
+        m_pTileDiedOffsets[i] = died * 2;
+        born += m_pTileCounts[i];
+        died += m_pTileDied[i];
+    }
+    // The counts are known before any cell is written, so the lists are
+    // sized exactly; the previous frame's entries need not be kept
+    const int64_t deltaLimit = (int64_t)rows * cols * 2 + 2;
+    golReservePoints(m_pBorn, m_bornCapacity, born * 2 + 2, 0, deltaLimit);
+    golReservePoints(m_pDied, m_diedCapacity, died * 2 + 2, 0, deltaLimit);
+    m_stats.mergeNs += golNowNs() - t;
+
+    runTask(kTaskCollectDelta);
+
+    t = golNowNs();
+    setDeltaCounts(born * 2, died * 2);
+    const uint64_t end = golNowNs();
+    m_stats.clearNs += end - t;
+    m_stats.totalNs += end - start;
+    m_stats.frames++;
+}
+
+// Draws the current generation into raster, see GolRaster, instead of
+// listing its live cells. The pixel rows are split evenly over the tiles,
+// so the workers share the drawing whatever the zoom.
+void CppThreadsComputer::render(const GolRaster& raster){
+    const uint64_t start = golNowNs();
+    if (raster.width > m_rasterColumnsSize) {
+        delete[] m_pRasterColumns;
+        m_pRasterColumns = new int32_t[raster.width];
+        m_rasterColumnsSize = raster.width;
+    }
+    golRasterColumns(raster, cols, m_pRasterColumns);
+    m_pRaster = &raster;
+    runTask(kTaskRaster);
+    m_pRaster = nullptr;
+    m_stats.totalNs += golNowNs() - start;
+    m_stats.frames++;
+}
+
+// Scans the tile counts of the current generation, has the workers write
+// their cells and clears what is left of the previous output.
+void CppThreadsComputer::finishOutput(){
+    if (m_lod) {
+        finishDensity();
+        return;
+    }
+    uint64_t t = golNowNs();
+    const int64_t alive = scanTileCounts();
+    const int words = golPointWords(m_pointFormat);
+    reserveAlive(alive * words + words, 0);
+    uint64_t now = golNowNs();
+    m_stats.mergeNs += now - t;
+
+    runTask(kTaskCollect);
+
+    t = golNowNs();
+    setAliveCount(alive * golPointWords(m_pointFormat));
+    m_stats.clearNs += golNowNs() - t;
+}
+
+// Packs the weighted points the workers left in their tiles' parts of
+// m_pTileDensity into m_pDensity, in tile order, and clears what is left
+// of the previous output.
+void CppThreadsComputer::finishDensity(){
+    uint64_t t = golNowNs();
+    int64_t k = 0;
+    for (int i = 0; i < m_numTiles; i++) {
+        const int64_t n = m_pTileCounts[i] * kDensityPointFloats;
+        reserveDensity(k + n + kDensityPointFloats, k);
+        memcpy(m_pDensity + k, m_pTileDensity + i * m_tileDensityFloats, n * sizeof(float));
+        k += n;
+    }
+    uint64_t now = golNowNs();
+    m_stats.mergeNs += now - t;
+
+    setDensityCount(k);
+    m_stats.clearNs += golNowNs() - now;
+}
+
+// Turns the per-tile counts into output offsets (in words of the point
+// format) and returns the total number of live cells.
+int64_t CppThreadsComputer::scanTileCounts(){
+    const int words = golPointWords(m_pointFormat);
+    int64_t total = 0;
+    for (int i = 0; i < m_numTiles; i++) {
+        m_pTileOffsets[i] = total * words;
+        total += m_pTileCounts[i];
+    }
+    return total;
+}
+
+// Sets the height of the tiles handed out to workers. Smaller tiles balance
+// better, larger ones cost less in scheduling.
+void CppThreadsComputer::setTileRows(int tileRows){
+    m_requestedTileRows = tileRows;
+    const int blockRows = 1 << m_lod;
+    m_tileRows = tileRows < 1 ? 1 : tileRows;
+    m_tileRows = (m_tileRows + blockRows - 1) / blockRows * blockRows;
+    m_numTiles = (rows + m_tileRows - 1) / m_tileRows;
+    delete[] m_pTileCounts;
+    delete[] m_pTileOffsets;
+    delete[] m_pTileDied;
+    delete[] m_pTileDiedOffsets;
+    m_pTileCounts = new int64_t[m_numTiles]();
+    m_pTileOffsets = new int64_t[m_numTiles]();
+    m_pTileDied = new int64_t[m_numTiles]();
+    m_pTileDiedOffsets = new int64_t[m_numTiles]();
+    allocTileDensity();
+}
+
+// Sizes the per-tile density scratch for the current tiles and level.
+void CppThreadsComputer::allocTileDensity(){
+    delete[] m_pTileDensity;
+    delete[] m_pTileSums;
+    m_pTileDensity = nullptr;
+    m_pTileSums = nullptr;
+    if (!m_lod) {
+        return;
+    }
+    m_densityBlocks = golDensityBlocks(cols, m_lod);
+    m_tileDensityFloats = (int64_t)(m_tileRows >> m_lod) * m_densityBlocks * kDensityPointFloats;
+    m_pTileDensity = new float[m_numTiles * m_tileDensityFloats];
+    m_pTileSums = new uint32_t[(int64_t)m_numTiles * m_densityBlocks]();
+}
+
+// Slowest worker's stepping time over the mean, since the last reset.
+// 1.0 means perfectly balanced.
+double CppThreadsComputer::loadImbalance() const{
+    uint64_t total = 0;
+    uint64_t slowest = 0;
+    for (int t = 0; t < m_numThreads; t++) {
+        total += m_pSlots[t].busyNs;
+        slowest = m_pSlots[t].busyNs > slowest ? m_pSlots[t].busyNs : slowest;
+    }
+    return total ? (double)slowest * m_numThreads / total : 1.0;
+}
+
+int CppThreadsComputer::stolenTiles() const{
+    int stolen = 0;
+    for (int t = 0; t < m_numThreads; t++) {
+        stolen += m_pSlots[t].stolen;
+    }
+    return stolen;
+}
+
+void CppThreadsComputer::resetSchedulerStats(){
+    for (int t = 0; t < m_numThreads; t++) {
+        m_pSlots[t].busyNs = 0;
+        m_pSlots[t].stolen = 0;
+    }
+}
+
+// Records k words (floats, or packed cells) as this frame's output and
+// zeroes what is left of a larger previous population, so the buffer stays
+// zero terminated without clearing all rows * cols points every frame.
+void CppThreadsComputer::setAliveCount(int64_t k)
+{
+    const int words = golPointWords(m_pointFormat);
+    reserveAlive(k + words, k);
+    if (k < m_aliveCount * words) {
+        if (m_pointFormat == kPointFormatCells) {
+            memset(m_pAliveCells + k, 0, (m_aliveCount - k) * sizeof(uint32_t));
+        } else {
+            memset(m_pAliveLocs + k, 0, (m_aliveCount * 2 - k) * sizeof(float));
         }
     }
-    
+    m_aliveCount = k / words;
+}
+
+// Same as setAliveCount for the weighted points in m_pDensity.
+void CppThreadsComputer::setDensityCount(int64_t k)
+{
+    reserveDensity(k + kDensityPointFloats, k);
+    if (k < m_densityCount * kDensityPointFloats) {
+        memset(m_pDensity + k, 0, (m_densityCount * kDensityPointFloats - k) * sizeof(float));
+    }
+    m_densityCount = k / kDensityPointFloats;
+}
+
+// Same as setAliveCount for the born and died lists.
+void CppThreadsComputer::setDeltaCounts(int64_t bornK, int64_t diedK)
+{
+    if (bornK < m_bornCount * 2) {
+        memset(m_pBorn + bornK, 0, (m_bornCount * 2 - bornK) * sizeof(float));
+    }
+    if (diedK < m_diedCount * 2) {
+        memset(m_pDied + diedK, 0, (m_diedCount * 2 - diedK) * sizeof(float));
+    }
+    m_bornCount = bornK / 2;
+    m_diedCount = diedK / 2;
+}
+
+// Makes room for need words of per-cell output, keeping the first keep,
+// see golReservePoints.
+void CppThreadsComputer::reserveAlive(int64_t need, int64_t keep)
+{
+    const int words = golPointWords(m_pointFormat);
+    const int64_t limit = (int64_t)rows * cols * words + words;
+    if (m_pointFormat == kPointFormatCells) {
+        golReservePoints(m_pAliveCells, m_aliveCapacity, need, keep, limit);
+    } else {
+        golReservePoints(m_pAliveLocs, m_aliveCapacity, need, keep, limit);
+    }
+}
+
+// Same as reserveAlive for m_pDensity, whose limit is a point per block at
+// level 1, the level with the most blocks.
+void CppThreadsComputer::reserveDensity(int64_t need, int64_t keep)
+{
+    const int64_t limit = (int64_t)golDensityBlocks(rows, 1) * golDensityBlocks(cols, 1) * kDensityPointFloats + kDensityPointFloats;
+    golReservePoints(m_pDensity, m_densityCapacity, need, keep, limit);
+}
+
+// Releases the parked workers on task (a ThreadTask) and waits for them.
+void CppThreadsComputer::runTask(int task){
+    std::mutex* mutex = (std::mutex*)m_pMutex;
+    const bool stepping = isStepTask(task);
+    m_task = task;
+    if (stepping) {
+        const uint64_t t = golNowNs();
+        golRefreshGhosts(m_pGrid, rows, cols, m_boundary);
+        m_stats.borderNs += golNowNs() - t;
+    }
+    const uint64_t start = golNowNs();
+    for (int t = 0; t < m_numThreads; t++) {
+        uint32_t front = (uint32_t)((int64_t)m_numTiles * t / m_numThreads);
+        uint32_t back = (uint32_t)((int64_t)m_numTiles * (t + 1) / m_numThreads);
+        m_pSlots[t].range.store(packRange(front, back), std::memory_order_relaxed);
+    }
+    m_pendingWorkers.store(m_numThreads, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(*mutex);
+        m_generation.fetch_add(1, std::memory_order_release);
+    }
+    ((std::condition_variable*)m_pWorkCv)->notify_all();
+
+    for (int i = 0; i < kSpinIterations && m_pendingWorkers.load(std::memory_order_acquire) != 0; i++) {
+        std::this_thread::yield();
+    }
+    if (m_pendingWorkers.load(std::memory_order_acquire) != 0) {
+        std::unique_lock<std::mutex> lock(*mutex);
+        ((std::condition_variable*)m_pDoneCv)->wait(lock, [&] {
+            return m_pendingWorkers.load(std::memory_order_acquire) == 0;
+        });
+    }
+
+    // The slowest worker is the phase itself; the rest of the wall time
+    // went into waking the pool and waiting on it
+    uint64_t slowest = 0;
+    for (int t = 0; t < m_numThreads; t++) {
+        slowest = m_pSlots[t].lastNs > slowest ? m_pSlots[t].lastNs : slowest;
+    }
+    const uint64_t wall = golNowNs() - start;
+    (stepping ? m_stats.stepNs : m_stats.collectNs) += slowest;
+    m_stats.syncNs += wall > slowest ? wall - slowest : 0;
+}
+
+void CppThreadsComputer::runTile(int tile) {
+    const int startRow = tile * m_tileRows;
+    const int endRow = (startRow + m_tileRows < rows) ? startRow + m_tileRows : rows;
+
+    // Only the viewport is counted and collected
+    const int viewStart = startRow > m_view.y0 ? startRow : m_view.y0;
+    const int viewEnd = endRow < m_view.y1 ? endRow : m_view.y1;
+    const int viewWidth = m_view.x1 - m_view.x0;
+
+    if (m_task == kTaskRaster) {
+        const int py0 = (int)((int64_t)m_pRaster->height * tile / m_numTiles);
+        const int py1 = (int)((int64_t)m_pRaster->height * (tile + 1) / m_numTiles);
+        golRasterizeRows(*m_pRaster, m_pRasterColumns, m_pGrid + stride + 1, rows, stride, py0, py1);
+        return;
+    }
+
+    // m_pNewGrid still holds the previous generation
+    if (m_task == kTaskCollectDelta) {
+        int64_t bornK = m_pTileOffsets[tile];
+        int64_t diedK = m_pTileDiedOffsets[tile];
+        for (int y = viewStart; y < viewEnd; y++) {
+            const int64_t offset = (y + 1) * stride + 1 + m_view.x0;
+            golCollectDeltaRow(m_pNewGrid + offset, m_pGrid + offset, viewWidth, m_view.x0, y, cellSize,
+                               m_pBorn, &bornK, m_pDied, &diedK);
+        }
+        return;
+    }
+
+    if (m_task == kTaskCollect && m_pointFormat == kPointFormatCells) {
+        int64_t k = m_pTileOffsets[tile];
+        for (int y = viewStart; y < viewEnd; y++) {
+            k = golCollectCellsRow(m_pGrid + (y + 1) * stride + 1 + m_view.x0, viewWidth, m_view.x0, y, m_pAliveCells, k);
+        }
+        return;
+    }
+
+    if (m_task == kTaskCollect) {
+        int64_t k = m_pTileOffsets[tile];
+        for (int y = viewStart; y < viewEnd; y++) {
+            k = golCollectRow(m_pGrid + (y + 1) * stride + 1 + m_view.x0, viewWidth, m_view.x0, y, cellSize, m_pAliveLocs, k);
+        }
+        return;
+    }
+
+    int64_t count = 0;
+    if (m_task == kTaskCount) {
+        for (int y = viewStart; y < viewEnd; y++) {
+            count = countRow(tile, y, m_pGrid + (y + 1) * stride + 1, count);
+        }
+        m_pTileCounts[tile] = m_lod ? count / kDensityPointFloats : count;
+        return;
+    }
+
+    // The ghost frame makes every row, edges included, a plain kernel call
+    int64_t died = 0;
+    for (int y = startRow; y < endRow; y++) {
+        const uint8_t* row = m_pGrid + (y + 1) * stride + 1;
+        uint8_t* out = m_pNewGrid + (y + 1) * stride + 1;
+
+        golStepRow(row - stride, row, row + stride, out, cols);
+        if (y < viewStart || y >= viewEnd) {
+            continue;
+        }
+        if (m_task == kTaskStepCount) {
+            count = countRow(tile, y, out, count);
+        } else if (m_task == kTaskStepDelta) {
+            golCountDeltaRow(row + m_view.x0, out + m_view.x0, viewWidth, &count, &died);
+        }
+    }
+    m_pTileCounts[tile] = m_lod && m_task == kTaskStepCount ? count / kDensityPointFloats : count;
+    m_pTileDied[tile] = died;
+}
+
+// Counts row y, whose column 0 is at row, towards tile's output: adds its
+// live cells in the viewport to count, or with a level of detail adds them
+// to the tile's block sums and, once a block row is complete, appends its
+// weighted points to the tile's part of m_pTileDensity, count being the
+// floats written there so far.
+int64_t CppThreadsComputer::countRow(int tile, int y, const uint8_t* row, int64_t count) {
+    if (!m_lod) {
+        return count + golCountRow(row + m_view.x0, m_view.x1 - m_view.x0);
+    }
+    uint32_t* sums = m_pTileSums + (int64_t)tile * m_densityBlocks;
+    golDensityAddRow(row, m_view.x0, m_view.x1, m_lod, sums);
+    const int blockMask = (1 << m_lod) - 1;
+    if ((y & blockMask) == blockMask || y + 1 == m_view.y1) {
+        count = golDensityFlush(sums, m_view.x0 >> m_lod, golDensityBlocks(m_view.x1, m_lod), y >> m_lod,
+                                m_lod, cellSize, m_pTileDensity + tile * m_tileDensityFloats, count);
+    }
     return count;
-}
\ No newline at end of file
+}
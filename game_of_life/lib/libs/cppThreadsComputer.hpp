@@ -1,33 +1,118 @@
+#pragma once
 #include <cstdint>
 #include <atomic>
-#include <vector>
-#include <utility>
+#include "cppStats.hpp"
+#include "cppSeed.hpp"
+#include "cppViewport.hpp"
+#include "cppDensity.hpp"
+#include "cppRaster.hpp"
+#include "cppPoints.hpp"
+
+struct WorkerSlot;
 
 class CppThreadsComputer
 {
-    uint8_t *m_pGrid;
+    uint8_t *m_pGrid;     // (rows + 2) x (cols + 2) with a ghost frame
     uint8_t *m_pNewGrid;  // Pre-allocated grid for next generation
-    float *m_pAliveLocs;
+    float *m_pAliveLocs = nullptr;  // Live cell centres (kPointFormatFloats)
+    uint32_t *m_pAliveCells = nullptr;  // Packed cells instead, see setPointFormat
+    float *m_pDensity = nullptr;  // Weighted points while m_lod > 0
+    float *m_pBorn = nullptr;     // Cells that came alive in the last updateDeltas
+    float *m_pDied = nullptr;     // Cells that died in it
     int rows = 0;
     int cols = 0;
+    int64_t stride = 0;   // 64-bit so row offsets of large grids do not overflow
+    int m_boundary = 0;   // GolBoundary
+    int64_t m_aliveCount = 0;  // Points written to m_pAliveLocs by the last frame
+    GolViewport m_view{};  // Cells that get output points, see setViewport
+    int m_pointFormat = kPointFormatFloats;  // GolPointFormat of the per-cell output
+    int m_lod = 0;         // Density level of the output, see setLod
+    int64_t m_densityCount = 0;  // Weighted points written to m_pDensity by the last frame
+    int64_t m_bornCount = 0;
+    int64_t m_diedCount = 0;
+    int64_t m_aliveCapacity = 0;    // Words allocated for m_pAliveLocs or m_pAliveCells
+    int64_t m_densityCapacity = 0;  // Floats allocated for m_pDensity
+    int64_t m_bornCapacity = 0;
+    int64_t m_diedCapacity = 0;
     int m_numThreads = 8;
     double cellSize = 0;
+    GolStats m_stats{};
 
     
 private:
     void* m_pMutex;
     void* m_pThreadsList;
+    void* m_pWorkCv;   // (std::condition_variable*) parks workers between generations
+    void* m_pDoneCv;   // (std::condition_variable*) parks update() until all tiles are done
+    std::atomic<uint64_t> m_generation{0};  // bumped by update() to release the workers
+    std::atomic<int> m_pendingWorkers{0};
+    std::atomic<bool> m_stopping{false};
+    int m_task = 0;         // What the workers do when released, see runTask
+    int m_tileRows = 0;     // Rows per tile, the unit of work stealing
+    int m_requestedTileRows = 0;  // As passed to setTileRows, before rounding to whole blocks
+    int m_numTiles = 0;
+    int64_t* m_pTileCounts;     // Per tile: live cells (or weighted points) in its rows
+    int64_t* m_pTileOffsets;    // Per tile: exclusive scan of m_pTileCounts
+    int64_t* m_pTileDied;       // Per tile, for updateDeltas: cells that died (m_pTileCounts: born)
+    int64_t* m_pTileDiedOffsets;  // Per tile: exclusive scan of m_pTileDied
+    WorkerSlot* m_pSlots;   // Per worker: tile deque and statistics
+    float* m_pTileDensity = nullptr;      // Per tile: its weighted points, m_tileDensityFloats apart
+    uint32_t* m_pTileSums = nullptr;      // Per tile: block sums of its current block row
+    int64_t m_tileDensityFloats = 0;
+    int m_densityBlocks = 0;              // Blocks across the grid at m_lod
+    const GolRaster* m_pRaster = nullptr; // Target of the running kTaskRaster
+    int32_t* m_pRasterColumns = nullptr;  // Grid column per pixel column
+    int m_rasterColumnsSize = 0;
 
 public:
-    CppThreadsComputer(int32_t nRows, int32_t nCols, double cellSize);
+    CppThreadsComputer(int32_t nRows, int32_t nCols, double cellSize, int numThreads = 0, const void* cells = nullptr, int format = kCellFormatBytes);
     ~CppThreadsComputer();
     float* update();
+    void step(int gens);
+    float* collect();
+    void render(const GolRaster& raster);
+    void updateDeltas();
+    const float* born() const { return m_pBorn; }
+    const float* died() const { return m_pDied; }
+    int64_t bornCount() const { return m_bornCount; }
+    int64_t diedCount() const { return m_diedCount; }
+    void setBoundary(int mode);
+    void setViewport(int x0, int y0, int x1, int y1);
+    void setLod(int level);
+    bool setPointFormat(int format);
+    void seed(uint32_t seed, double density);
+    void load(const void* cells, int format = kCellFormatBytes);
+    void applyEdits(const int32_t* xy, const uint8_t* states, int n);
+    int64_t aliveCount() const { return m_lod ? m_densityCount : m_aliveCount; }
+    int lod() const { return m_lod; }
+    int pointFormat() const { return m_pointFormat; }
+    int pointFloats() const { return m_lod ? kDensityPointFloats : golPointWords(m_pointFormat); }
+    const GolStats& stats() const { return m_stats; }
+    void resetStats() { m_stats = GolStats{}; }
+    void setTileRows(int tileRows);
+    double loadImbalance() const;
+    int stolenTiles() const;
+    void resetSchedulerStats();
 
 private:
-    void initData();
+    void initData(const void* cells, int format);
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop(int t);
+    void runTask(int task);
+    int64_t scanTileCounts();
+    void finishOutput();
+    void finishDensity();
+    void allocTileDensity();
+    int64_t countRow(int tile, int y, const uint8_t* row, int64_t count);
+    int popTile(int t);
+    int stealTile(int t);
+    float* output();
+    void reserveAlive(int64_t need, int64_t keep);
+    void reserveDensity(int64_t need, int64_t keep);
+    void setAliveCount(int64_t k);
+    void setDensityCount(int64_t k);
+    void setDeltaCounts(int64_t bornK, int64_t diedK);
     void populateInputGridWithBools();
-    int32_t countNeighbors(int x, int y);
-    int32_t countNeighborsBounds(int x, int y);
-    void updateChunk(int startRow, int endRow, std::atomic<int>& aliveCounter);
-    void updateChunkLockFree(int startRow, int endRow, std::vector<std::pair<float, float>>& result);
+    void runTile(int tile);
 };
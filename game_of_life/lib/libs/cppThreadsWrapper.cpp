@@ -1,22 +1,238 @@
 #include <cstdint>
 #include "cppThreadsComputer.hpp"
+#include "cppRunner.hpp"
 #define EXPORT extern "C" __attribute__((visibility("default"))) __attribute__((used))
 
 CppThreadsComputer* cppThreadsComp = nullptr;
+CppRunner* cppThreadsRunner = nullptr;  // Created by the first startAsyncCppThreads
+int64_t cppThreadsCompCells = 0;
 
 EXPORT
 void initCppThreads(int nRows, int nCols, double cellSize){
+    cppThreadsCompCells = (int64_t)nRows * nCols;
     cppThreadsComp = new CppThreadsComputer(nRows, nCols, cellSize);
 }
 
+// Same as initCppThreads with an explicit worker count.
+EXPORT
+void initCppThreadsN(int nRows, int nCols, double cellSize, int numThreads){
+    cppThreadsCompCells = (int64_t)nRows * nCols;
+    cppThreadsComp = new CppThreadsComputer(nRows, nCols, cellSize, numThreads);
+}
+
+// Same as initCppThreadsN, but starts from cells (rows * cols, in the GolCellFormat
+// given by format: 0 = bytes, 1 = bits, 2 = floats) instead of a random
+// soup. The cells are converted in one pass and not kept.
+EXPORT
+void initCppThreadsFrom(int nRows, int nCols, double cellSize, int numThreads, const void* cells, int format){
+    cppThreadsCompCells = (int64_t)nRows * nCols;
+    cppThreadsComp = new CppThreadsComputer(nRows, nCols, cellSize, numThreads, cells, format);
+}
+
 EXPORT
 float* updateCppThreads(){
     auto retVal = cppThreadsComp->update();
     return retVal;
 }
 
+// Same as updateCppThreads, and writes the number of live cells to count. Only
+// the first 2 * count floats of the returned buffer are meaningful.
+EXPORT
+float* updateCountedCppThreads(int64_t* count){
+    auto retVal = cppThreadsComp->update();
+    *count = cppThreadsComp->aliveCount();
+    return retVal;
+}
+
+// Advances one generation and lists only the cells that changed, within
+// the viewport: born receives a buffer of bornCount "x, y" points that
+// came alive and died one of diedCount points that died, both laid
+// out like updateCppThreads's output. The live cell buffer is not
+// rebuilt; call collectAliveCppThreads for a full frame, e.g. after
+// moving the viewport.
+EXPORT
+void updateDeltasCppThreads(const float** born, int64_t* bornCount, const float** died, int64_t* diedCount){
+    cppThreadsComp->updateDeltas();
+    *born = cppThreadsComp->born();
+    *bornCount = cppThreadsComp->bornCount();
+    *died = cppThreadsComp->died();
+    *diedCount = cppThreadsComp->diedCount();
+}
+
+// Live cells in the buffer returned by the last update or collect.
+EXPORT
+int64_t aliveCountCppThreads(){
+    return cppThreadsComp->aliveCount();
+}
+
+// Advances generations without rebuilding the output buffer.
+EXPORT
+void stepCppThreads(int generations){
+    cppThreadsComp->step(generations);
+}
+
+// Rebuilds the output buffer from the current generation.
+EXPORT
+float* collectAliveCppThreads(){
+    auto retVal = cppThreadsComp->collect();
+    return retVal;
+}
+
+// Replaces the grid with a random soup; the same seed and density give
+// the same soup on every platform.
+EXPORT
+void seedCppThreads(uint32_t seed, double density){
+    cppThreadsComp->seed(seed, density);
+}
+
+// Replaces the grid with rows * cols bytes in row-major order, non-zero
+// meaning alive.
+EXPORT
+void loadCellsCppThreads(const uint8_t* cells){
+    cppThreadsComp->load(cells);
+}
+
+// Sets or toggles n cells between generations without rebuilding the
+// engine: cell (xy[2i], xy[2i+1]) takes states[i] (0 = dead, 1 = alive,
+// 2 = toggle). Cells outside the grid are ignored.
+EXPORT
+void applyEditsCppThreads(const int32_t* xy, const uint8_t* states, int n){
+    cppThreadsComp->applyEdits(xy, states, n);
+}
+
+// Copies the per-phase timings accumulated since the last reset to out.
+EXPORT
+void getStatsCppThreads(GolStats* out){
+    *out = cppThreadsComp->stats();
+}
+
+EXPORT
+void resetStatsCppThreads(){
+    cppThreadsComp->resetStats();
+}
+
+// Restricts output to the cells in [x0, x1) x [y0, y1) (clipped to the
+// grid), e.g. the part that is on screen. Cells outside are still
+// simulated. Counts and buffers then cover the viewport only.
+EXPORT
+void setViewportCppThreads(int x0, int y0, int x1, int y1){
+    cppThreadsComp->setViewport(x0, y0, x1, y1);
+}
+
+// Switches the output to one weighted point "x, y, weight" per live
+// 2^level x 2^level block (level 1 to 6), the weight being its live
+// fraction, for zoomed-out views; 0 goes back to a point per live cell.
+// Counts then count weighted points, see cppDensity.hpp. Tiles are
+// rounded up to whole blocks while a level is set.
+EXPORT
+void setLodCppThreads(int level){
+    cppThreadsComp->setLod(level);
+}
+
+// Switches the per-cell output to GolPointFormat format: 0 = "x, y" float
+// centres, 1 = one packed word per live cell, x | y << 16, for consumers
+// that apply the cell size themselves. Density output is not affected.
+// Returns 0, or -1 for an unknown format or a side over 65536 cells.
+EXPORT
+int setPointFormatCppThreads(int format){
+    return cppThreadsComp->setPointFormat(format) ? 0 : -1;
+}
+
+// Draws the current generation into pixels, a width x height buffer in
+// GolPixelFormat format (0 = RGBA8, 1 = 8-bit gray), instead of listing
+// live cells; after stepCppThreads this gives one image per frame. Cell
+// (x, y) covers (x, y) * cellPixels scene units and scene point s lands
+// on pixel s * zoom + offset. Colours are 0xAARRGGBB; pixels off the grid
+// get deadColor.
+EXPORT
+void renderCppThreads(uint8_t* pixels, int width, int height, int format, double cellPixels, double zoom,
+                      double offsetX, double offsetY, uint32_t aliveColor, uint32_t deadColor){
+    const GolRaster raster{pixels, width, height, format, cellPixels, zoom, offsetX, offsetY, aliveColor, deadColor};
+    cppThreadsComp->render(raster);
+}
+
+// Edge handling, see GolBoundary: 0 = dead border, 1 = torus, 2 = Klein bottle.
+EXPORT
+void setBoundaryCppThreads(int mode){
+    cppThreadsComp->setBoundary(mode);
+}
+
+// Rows per tile handed out by the work-stealing scheduler.
+EXPORT
+void setTileRowsCppThreads(int tileRows){
+    cppThreadsComp->setTileRows(tileRows);
+}
+
+// Slowest worker's stepping time over the mean since the last reset;
+// 1.0 is a perfect balance.
+EXPORT
+double loadImbalanceCppThreads(){
+    return cppThreadsComp->loadImbalance();
+}
+
+// Tiles taken from another worker's deque since the last reset.
+EXPORT
+int stolenTilesCppThreads(){
+    return cppThreadsComp->stolenTiles();
+}
+
+EXPORT
+void resetSchedulerStatsCppThreads(){
+    cppThreadsComp->resetSchedulerStats();
+}
+
+// Steps the engine on a background thread at gensPerSecond (<= 0: as fast
+// as possible) until stopAsyncCppThreads. Calling it again only changes the
+// rate. While it runs, use only latestFrameCppThreads, setTargetRateCppThreads and
+// stopAsyncCppThreads; everything else would race with the simulation thread.
+EXPORT
+void startAsyncCppThreads(double gensPerSecond){
+    if (!cppThreadsRunner) {
+        cppThreadsRunner = new CppRunner(cppThreadsCompCells, [](int64_t* count, int32_t* pointFloats, int32_t* lod) {
+            const float* locs = cppThreadsComp->update();
+            *count = cppThreadsComp->aliveCount();
+            *pointFloats = cppThreadsComp->pointFloats();
+            *lod = cppThreadsComp->lod();
+            return locs;
+        });
+    }
+    cppThreadsRunner->start(gensPerSecond);
+}
+
+EXPORT
+void setTargetRateCppThreads(double gensPerSecond){
+    if (cppThreadsRunner) {
+        cppThreadsRunner->setTargetRate(gensPerSecond);
+    }
+}
+
+// The newest frame the background thread has finished, without waiting
+// for it, with its layout: count points of pointFloats 32-bit words each,
+// at density level lod (0: per-cell output, packed when pointFloats is 1).
+// generation counts the generations stepped since startAsyncCppThreads.
+// Any out-param may be null. Before the first startAsyncCppThreads the frame
+// is empty. The buffer is valid until the next call.
+EXPORT
+float* latestFrameCppThreads(int64_t* count, int32_t* pointFloats, int32_t* lod, uint64_t* generation){
+    if (!cppThreadsRunner) {
+        return CppRunner::emptyFrame(count, pointFloats, lod, generation);
+    }
+    return cppThreadsRunner->latest(count, pointFloats, lod, generation);
+}
+
+// Stops the background thread; returns once it has finished its last
+// generation, after which the other calls may be used again.
+EXPORT
+void stopAsyncCppThreads(){
+    if (cppThreadsRunner) {
+        cppThreadsRunner->stop();
+    }
+}
+
 EXPORT
 void destructCppThreads(){
+    delete cppThreadsRunner;
+    cppThreadsRunner = nullptr;
     delete cppThreadsComp;
     cppThreadsComp = nullptr;
 }
@@ -0,0 +1,286 @@
+#include "cppTiledComputer.hpp"
+#include "cppSimdKernel.hpp"
+#include "cppBoundary.hpp"
+#include "cppSeed.hpp"
+#include "cppViewport.hpp"
+#include "cppRaster.hpp"
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
+
+// Tiles are kTileSize x kTileSize cells; edge tiles may be smaller.
+static const int kTileSize = 64;
+
+CppTiledComputer::CppTiledComputer(int32_t nRows, int32_t nCols, double cellSize, const void* cells, int format)
+: rows(nRows), cols(nCols), cellSize(cellSize)
+{
+    stride = cols + 2;
+    tilesX = (cols + kTileSize - 1) / kTileSize;
+    tilesY = (rows + kTileSize - 1) / kTileSize;
+    m_view = golFullViewport(rows, cols);
+    initData(cells, format);
+}
+
+CppTiledComputer::~CppTiledComputer()
+{
+    delete[] m_pGrid;
+    delete[] m_pNewGrid;
+    delete[] m_pChanged;
+    delete[] m_pNewChanged;
+    delete[] m_pTileAlive;
+    delete[] m_pAliveLocs;
+    delete[] m_pRasterColumns;
+}
+
+// Starts from cells when given, see load, and from the legacy soup
+// otherwise.
+void CppTiledComputer::initData(const void* cells, int format)
+{
+    m_pGrid = new uint8_t[(rows + 2) * stride]();
+    m_pNewGrid = new uint8_t[(rows + 2) * stride]();
+    if (cells) {
+        golImportCells(m_pGrid + stride + 1, rows, cols, stride, cells, format);
+    } else {
+        populateWithBools();
+    }
+
+    // Everything counts as changed until it has been computed once
+    m_pChanged = new uint8_t[tilesX * tilesY];
+    m_pNewChanged = new uint8_t[tilesX * tilesY];
+    memset(m_pChanged, 1, tilesX * tilesY);
+    m_pTileAlive = new uint8_t[tilesX * tilesY]();
+}
+
+void CppTiledComputer::populateWithBools()
+{
+    // Same soup as CppComputer
+    srand(7);
+    for (int y = 0; y < rows; ++y)
+    {
+        for (int x = 0; x < cols; ++x)
+        {
+            m_pGrid[(y + 1) * stride + x + 1] = rand() % 2;
+        }
+    }
+}
+
+// Replaces the grid with a soup of the given density, see golSeedSoup.
+void CppTiledComputer::seed(uint32_t seed, double density)
+{
+    golSeedSoup(m_pGrid + stride + 1, rows, cols, stride, seed, density);
+    markAllChanged();
+}
+
+// Replaces the grid with cells, rows * cols cells in the given
+// GolCellFormat.
+void CppTiledComputer::load(const void* cells, int format)
+{
+    golImportCells(m_pGrid + stride + 1, rows, cols, stride, cells, format);
+    markAllChanged();
+}
+
+// Makes the next update recompute every tile, which also refreshes
+// m_pTileAlive. Needed whenever cells change outside of update().
+void CppTiledComputer::markAllChanged()
+{
+    memset(m_pChanged, 1, tilesX * tilesY);
+    m_edgeChanged = true;
+}
+
+// Applies n edits between generations: cell (xy[2i], xy[2i+1]) takes
+// GolEdit states[i]. Cells outside the grid are ignored. Only the tiles
+// that were edited are marked changed, so the cost is O(n) plus the
+// recompute of their neighbourhoods. The output buffer is not touched until the next update or collect.
+void CppTiledComputer::applyEdits(const int32_t* xy, const uint8_t* states, int n)
+{
+    for (int i = 0; i < n; i++) {
+        const int x = xy[2 * i];
+        const int y = xy[2 * i + 1];
+        if (x < 0 || y < 0 || x >= cols || y >= rows) {
+            continue;
+        }
+        uint8_t& cell = m_pGrid[(y + 1) * stride + x + 1];
+        cell = golEditedCell(cell, states[i]);
+
+        // Wakes the tile and, through isTileActive, its neighbours
+        const int tx = x / kTileSize;
+        const int ty = y / kTileSize;
+        m_pChanged[ty * tilesX + tx] = 1;
+        if (tx == 0 || ty == 0 || tx == tilesX - 1 || ty == tilesY - 1) {
+            m_edgeChanged = true;
+        }
+    }
+}
+
+// Limits output points to the cells in [x0, x1) x [y0, y1), clipped to
+// the grid. Takes effect from the next update or collect.
+void CppTiledComputer::setViewport(int x0, int y0, int x1, int y1)
+{
+    m_view = golClampViewport(x0, y0, x1, y1, rows, cols);
+}
+
+void CppTiledComputer::setBoundary(int mode)
+{
+    m_boundary = mode;
+    // The frame feeds every edge tile, so recompute everything once
+    markAllChanged();
+}
+
+float* CppTiledComputer::update(){
+    golRefreshGhosts(m_pGrid, rows, cols, m_boundary);
+
+    m_activeTiles = 0;
+    for (int ty = 0; ty < tilesY; ty++) {
+        for (int tx = 0; tx < tilesX; tx++) {
+            if (isTileActive(tx, ty)) {
+                updateTile(tx, ty);
+                m_activeTiles++;
+            } else {
+                // m_pNewGrid still holds the previous generation of this
+                // tile, which equals the current one because it is stable.
+                m_pNewChanged[ty * tilesX + tx] = 0;
+            }
+        }
+    }
+
+    // Swap grids
+    uint8_t* temp = m_pGrid;
+    m_pGrid = m_pNewGrid;
+    m_pNewGrid = temp;
+
+    temp = m_pChanged;
+    m_pChanged = m_pNewChanged;
+    m_pNewChanged = temp;
+
+    m_edgeChanged = isEdgeChanged();
+    setAliveCount(collectAlive());
+    return m_pAliveLocs;
+}
+
+// Rebuilds m_pAliveLocs from the current generation. Unlike update() this
+// does not trust m_pTileAlive, which is stale until every tile has been
+// computed once.
+float* CppTiledComputer::collect(){
+    int64_t k = 0;
+    const int width = m_view.x1 - m_view.x0;
+    for (int y = m_view.y0; y < m_view.y1; y++) {
+        reserveAlive(k + width * 2 + 2, k);
+        k = golCollectRow(m_pGrid + (y + 1) * stride + 1 + m_view.x0, width, m_view.x0, y, cellSize, m_pAliveLocs, k);
+    }
+    setAliveCount(k);
+    return m_pAliveLocs;
+}
+
+// Draws the current generation into raster, see GolRaster, instead of
+// listing its live cells.
+void CppTiledComputer::render(const GolRaster& raster){
+    if (raster.width > m_rasterColumnsSize) {
+        delete[] m_pRasterColumns;
+        m_pRasterColumns = new int32_t[raster.width];
+        m_rasterColumnsSize = raster.width;
+    }
+    golRasterColumns(raster, cols, m_pRasterColumns);
+    golRasterizeRows(raster, m_pRasterColumns, m_pGrid + stride + 1, rows, stride, 0, raster.height);
+}
+
+bool CppTiledComputer::isTileActive(int tx, int ty)
+{
+    // With a wrapping boundary border tiles also neighbour tiles on the
+    // opposite side. Rather than map those exactly (a Klein bottle mirrors
+    // them), any change along the border wakes the whole border.
+    if (m_boundary != kBoundaryDead && m_edgeChanged &&
+        (tx == 0 || ty == 0 || tx == tilesX - 1 || ty == tilesY - 1)) {
+        return true;
+    }
+    for (int y = ty - 1; y <= ty + 1; y++) {
+        if (y < 0 || y >= tilesY) continue;
+        for (int x = tx - 1; x <= tx + 1; x++) {
+            if (x < 0 || x >= tilesX) continue;
+            if (m_pChanged[y * tilesX + x]) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool CppTiledComputer::isEdgeChanged()
+{
+    for (int tx = 0; tx < tilesX; tx++) {
+        if (m_pChanged[tx] || m_pChanged[(tilesY - 1) * tilesX + tx]) {
+            return true;
+        }
+    }
+    for (int ty = 0; ty < tilesY; ty++) {
+        if (m_pChanged[ty * tilesX] || m_pChanged[ty * tilesX + tilesX - 1]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CppTiledComputer::updateTile(int tx, int ty)
+{
+    const int x0 = tx * kTileSize;
+    const int y0 = ty * kTileSize;
+    const int w = (x0 + kTileSize <= cols) ? kTileSize : cols - x0;
+    const int h = (y0 + kTileSize <= rows) ? kTileSize : rows - y0;
+
+    bool changed = false;
+    bool alive = false;
+    for (int y = y0; y < y0 + h; y++) {
+        const uint8_t* row = m_pGrid + (y + 1) * stride + x0 + 1;
+        uint8_t* out = m_pNewGrid + (y + 1) * stride + x0 + 1;
+
+        golStepRow(row - stride, row, row + stride, out, w);
+        changed = changed || memcmp(row, out, w) != 0;
+        alive = alive || memchr(out, 1, w) != nullptr;
+    }
+
+    m_pNewChanged[ty * tilesX + tx] = changed;
+    m_pTileAlive[ty * tilesX + tx] = alive;
+}
+
+// Records k floats as this frame's output and zeroes what is left of a
+// larger previous population, so the buffer stays (0, 0) terminated without
+// clearing all rows * cols points every frame.
+void CppTiledComputer::setAliveCount(int64_t k)
+{
+    reserveAlive(k + 2, k);
+    if (k < m_aliveCount * 2) {
+        memset(m_pAliveLocs + k, 0, (m_aliveCount * 2 - k) * sizeof(float));
+    }
+    m_aliveCount = k / 2;
+}
+
+// Makes room for need floats in m_pAliveLocs, keeping the first keep, see
+// golReservePoints. The buffer follows the population, so a mostly empty
+// grid does not pay for a point per cell.
+void CppTiledComputer::reserveAlive(int64_t need, int64_t keep)
+{
+    golReservePoints(m_pAliveLocs, m_aliveCapacity, need, keep, (int64_t)rows * cols * 2 + 2);
+}
+
+// Writes the live cells row by row, skipping empty tiles.
+int64_t CppTiledComputer::collectAlive()
+{
+    int64_t k = 0;
+    if (m_view.x0 >= m_view.x1) {
+        return 0;
+    }
+    // Only the tiles the viewport overlaps, clipped to it
+    const int firstTile = m_view.x0 / kTileSize;
+    const int endTile = (m_view.x1 - 1) / kTileSize + 1;
+    for (int y = m_view.y0; y < m_view.y1; y++) {
+        const uint8_t* tileAlive = m_pTileAlive + (y / kTileSize) * tilesX;
+        const uint8_t* row = m_pGrid + (y + 1) * stride + 1;
+        for (int tx = firstTile; tx < endTile; tx++) {
+            if (!tileAlive[tx]) continue;
+            const int x0 = tx * kTileSize > m_view.x0 ? tx * kTileSize : m_view.x0;
+            const int x1 = (tx + 1) * kTileSize < m_view.x1 ? (tx + 1) * kTileSize : m_view.x1;
+            reserveAlive(k + (x1 - x0) * 2 + 2, k);
+            k = golCollectRow(row + x0, x1 - x0, x0, y, cellSize, m_pAliveLocs, k);
+        }
+    }
+    return k;
+}
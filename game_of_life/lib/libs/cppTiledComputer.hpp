@@ -0,0 +1,59 @@
+//
+#pragma once
+#include <cstdint>
+#include "cppSeed.hpp"
+#include "cppViewport.hpp"
+#include "cppRaster.hpp"
+#include "cppPoints.hpp"
+
+// Byte-per-cell engine that only recomputes tiles whose own cells or a
+// neighbouring tile's cells changed in the previous generation, so the cost
+// of a step follows activity rather than rows * cols.
+class CppTiledComputer
+{
+    uint8_t *m_pGrid;      // Current generation, (rows + 2) x (cols + 2) with a ghost frame
+    uint8_t *m_pNewGrid;   // Next generation (pre-allocated)
+    uint8_t *m_pChanged;   // Per tile: changed in the last generation
+    uint8_t *m_pNewChanged;
+    uint8_t *m_pTileAlive; // Per tile: has live cells in the current generation
+    float *m_pAliveLocs = nullptr;  // i_0, j_0, i_1, j_1, ...
+    int32_t *m_pRasterColumns = nullptr;  // Grid column per pixel column, see render
+    int m_rasterColumnsSize = 0;
+    int rows = 0;
+    int cols = 0;
+    int64_t stride = 0;
+    int tilesX = 0;
+    int tilesY = 0;
+    int m_activeTiles = 0;
+    int m_boundary = 0;    // GolBoundary
+    int64_t m_aliveCount = 0;     // Points written to m_pAliveLocs by the last frame
+    int64_t m_aliveCapacity = 0;  // Floats allocated for m_pAliveLocs
+    GolViewport m_view{};  // Cells that get output points, see setViewport
+    bool m_edgeChanged = true; // Some tile on the grid border changed
+    double cellSize = 0;
+
+public:
+    CppTiledComputer(int32_t nRows, int32_t nCols, double cellSize, const void* cells = nullptr, int format = kCellFormatBytes);
+    ~CppTiledComputer();
+    float* update();
+    float* collect();
+    void render(const GolRaster& raster);
+    int activeTiles() const { return m_activeTiles; }
+    void setBoundary(int mode);
+    void setViewport(int x0, int y0, int x1, int y1);
+    void seed(uint32_t seed, double density);
+    void load(const void* cells, int format = kCellFormatBytes);
+    void applyEdits(const int32_t* xy, const uint8_t* states, int n);
+    int64_t aliveCount() const { return m_aliveCount; }
+
+private:
+    void initData(const void* cells, int format);
+    void populateWithBools();
+    void markAllChanged();
+    bool isTileActive(int tx, int ty);
+    bool isEdgeChanged();
+    void updateTile(int tx, int ty);
+    int64_t collectAlive();
+    void reserveAlive(int64_t need, int64_t keep);
+    void setAliveCount(int64_t k);
+};
@@ -0,0 +1,95 @@
+#include <cstdint>
+#include "cppTiledComputer.hpp"
+#define EXPORT extern "C" __attribute__((visibility("default"))) __attribute__((used))
+
+CppTiledComputer* cppTiledComp = nullptr;
+
+EXPORT
+void initCppTiled(int nRows, int nCols, double cellSize){
+    cppTiledComp = new CppTiledComputer(nRows, nCols, cellSize);
+}
+
+// Same as initCppTiled, but starts from cells (rows * cols, in the GolCellFormat
+// given by format: 0 = bytes, 1 = bits, 2 = floats) instead of a random
+// soup. The cells are converted in one pass and not kept.
+EXPORT
+void initCppTiledFrom(int nRows, int nCols, double cellSize, const void* cells, int format){
+    cppTiledComp = new CppTiledComputer(nRows, nCols, cellSize, cells, format);
+}
+
+EXPORT
+float* updateCppTiled(){
+    auto retVal = cppTiledComp->update();
+    return retVal;
+}
+
+// Same as updateCppTiled, and writes the number of live cells to count. Only
+// the first 2 * count floats of the returned buffer are meaningful.
+EXPORT
+float* updateCountedCppTiled(int64_t* count){
+    auto retVal = cppTiledComp->update();
+    *count = cppTiledComp->aliveCount();
+    return retVal;
+}
+
+// Number of tiles recomputed by the last update.
+EXPORT
+int activeTilesCppTiled(){
+    return cppTiledComp->activeTiles();
+}
+
+// Replaces the grid with a random soup; the same seed and density give
+// the same soup on every platform.
+EXPORT
+void seedCppTiled(uint32_t seed, double density){
+    cppTiledComp->seed(seed, density);
+}
+
+// Replaces the grid with rows * cols bytes in row-major order, non-zero
+// meaning alive.
+EXPORT
+void loadCellsCppTiled(const uint8_t* cells){
+    cppTiledComp->load(cells);
+}
+
+// Sets or toggles n cells between generations without rebuilding the
+// engine: cell (xy[2i], xy[2i+1]) takes states[i] (0 = dead, 1 = alive,
+// 2 = toggle). Cells outside the grid are ignored.
+EXPORT
+void applyEditsCppTiled(const int32_t* xy, const uint8_t* states, int n){
+    cppTiledComp->applyEdits(xy, states, n);
+}
+
+// Restricts output to the cells in [x0, x1) x [y0, y1) (clipped to the
+// grid), e.g. the part that is on screen. Cells outside are still
+// simulated. Counts and buffers then cover the viewport only.
+EXPORT
+void setViewportCppTiled(int x0, int y0, int x1, int y1){
+    cppTiledComp->setViewport(x0, y0, x1, y1);
+}
+
+// Draws the current generation into pixels, a width x height buffer in
+// GolPixelFormat format (0 = RGBA8, 1 = 8-bit gray), instead of listing
+// live cells; after updateCppTiled this gives one image per frame. Cell
+// (x, y) covers (x, y) * cellPixels scene units and scene point s lands
+// on pixel s * zoom + offset. Colours are 0xAARRGGBB; pixels off the grid
+// get deadColor.
+EXPORT
+void renderCppTiled(uint8_t* pixels, int width, int height, int format, double cellPixels, double zoom,
+                    double offsetX, double offsetY, uint32_t aliveColor, uint32_t deadColor){
+    const GolRaster raster{pixels, width, height, format, cellPixels, zoom, offsetX, offsetY, aliveColor, deadColor};
+    cppTiledComp->render(raster);
+}
+
+// Edge handling, see GolBoundary: 0 = dead border, 1 = torus, 2 = Klein bottle.
+EXPORT
+void setBoundaryCppTiled(int mode){
+    cppTiledComp->setBoundary(mode);
+}
+
+EXPORT
+void destructCppTiled(){
+    delete cppTiledComp;
+    cppTiledComp = nullptr;
+}
+
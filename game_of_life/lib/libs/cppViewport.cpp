@@ -0,0 +1,23 @@
+#include "cppViewport.hpp"
+
+GolViewport golFullViewport(int rows, int cols)
+{
+    return GolViewport{0, 0, cols, rows};
+}
+
+static int clampTo(int v, int n)
+{
+    return v < 0 ? 0 : (v > n ? n : v);
+}
+
+GolViewport golClampViewport(int x0, int y0, int x1, int y1, int rows, int cols)
+{
+    GolViewport view{clampTo(x0, cols), clampTo(y0, rows), clampTo(x1, cols), clampTo(y1, rows)};
+    if (view.x1 < view.x0) {
+        view.x1 = view.x0;
+    }
+    if (view.y1 < view.y0) {
+        view.y1 = view.y0;
+    }
+    return view;
+}
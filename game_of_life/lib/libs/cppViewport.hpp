@@ -0,0 +1,21 @@
+//
+#pragma once
+#include <cstdint>
+
+// Rectangle of cells, [x0, x1) x [y0, y1), that an engine writes output
+// points for. Cells outside it are still simulated, just not emitted, so
+// the output and the painter's work follow what is on screen.
+struct GolViewport
+{
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+};
+
+// The viewport covering all of a rows x cols grid, which engines start with.
+GolViewport golFullViewport(int rows, int cols);
+
+// (x0, y0)-(x1, y1) clipped to a rows x cols grid. An inverted or fully
+// outside rectangle gives an empty viewport.
+GolViewport golClampViewport(int x0, int y0, int x1, int y1, int rows, int cols);
@@ -0,0 +1,363 @@
+#include <cstdint>
+#include <mutex>
+#include "golApi.hpp"
+#include "cppRunner.hpp"
+#include "cppComputer.hpp"
+#include "cppThreadsComputer.hpp"
+#include "cppBitsComputer.hpp"
+#include "cppTiledComputer.hpp"
+#include "hashLifeComputer.hpp"
+#define EXPORT extern "C" __attribute__((visibility("default"))) __attribute__((used))
+
+struct GolInstance
+{
+    int engine;
+    int64_t cells = 0;
+    uint64_t generation = 0;
+    CppRunner* runner = nullptr;
+    CppComputer* cpp = nullptr;
+    CppThreadsComputer* threads = nullptr;
+    CppBitsComputer* bits = nullptr;
+    CppTiledComputer* tiled = nullptr;
+    HashLifeComputer* hashLife = nullptr;
+};
+
+// Without cells, the constructors fill the first generation with
+// srand/rand, which share one global state, so instances are only ever
+// built one at a time.
+static std::mutex createMutex;
+
+EXPORT
+GolInstance* gol_create(int engine, int rows, int cols, double cellSize, int numThreads){
+    return gol_create_from(engine, rows, cols, cellSize, numThreads, nullptr, kCellFormatBytes);
+}
+
+EXPORT
+GolInstance* gol_create_from(int engine, int rows, int cols, double cellSize, int numThreads,
+                             const void* cells, int format){
+    if (rows <= 0 || cols <= 0) {
+        return nullptr;
+    }
+    GolInstance* handle = new GolInstance();
+    handle->engine = engine;
+    handle->cells = (int64_t)rows * cols;
+
+    std::lock_guard<std::mutex> lock(createMutex);
+    switch (engine) {
+    case kGolEngineCpp:
+        handle->cpp = new CppComputer(rows, cols, cellSize, cells, format);
+        break;
+    case kGolEngineCppThreads:
+        handle->threads = new CppThreadsComputer(rows, cols, cellSize, numThreads, cells, format);
+        break;
+    case kGolEngineCppBits:
+        handle->bits = new CppBitsComputer(rows, cols, cellSize, cells, format);
+        break;
+    case kGolEngineCppTiled:
+        handle->tiled = new CppTiledComputer(rows, cols, cellSize, cells, format);
+        break;
+    case kGolEngineHashLife:
+        handle->hashLife = new HashLifeComputer(rows, cols, cellSize, cells, format);
+        break;
+    default:
+        delete handle;
+        return nullptr;
+    }
+    return handle;
+}
+
+EXPORT
+int gol_step(GolInstance* handle, int n){
+    if (n <= 0) {
+        return 0;
+    }
+    switch (handle->engine) {
+    case kGolEngineCpp:
+        handle->cpp->step(n);
+        break;
+    case kGolEngineCppThreads:
+        handle->threads->step(n);
+        break;
+    // These only step as part of an update, so they pay for an output
+    // pass per generation
+    case kGolEngineCppBits:
+        for (int g = 0; g < n; g++) {
+            handle->bits->update();
+        }
+        break;
+    case kGolEngineCppTiled:
+        for (int g = 0; g < n; g++) {
+            handle->tiled->update();
+        }
+        break;
+    // HashLife jumps 2^k generations at once; one jump per set bit of n,
+    // until the universe cannot grow any further
+    case kGolEngineHashLife: {
+        int advanced = 0;
+        for (int k = 0; (n >> k) != 0; k++) {
+            if (((n >> k) & 1) == 0) {
+                continue;
+            }
+            if (!handle->hashLife->step(k)) {
+                break;
+            }
+            advanced += 1 << k;
+        }
+        handle->generation += advanced;
+        return advanced;
+    }
+    }
+    handle->generation += n;
+    return n;
+}
+
+EXPORT
+const float* gol_collect(GolInstance* handle, int64_t* count){
+    const float* locs = nullptr;
+    int64_t alive = 0;
+    switch (handle->engine) {
+    case kGolEngineCpp:
+        locs = handle->cpp->collect();
+        alive = handle->cpp->aliveCount();
+        break;
+    case kGolEngineCppThreads:
+        locs = handle->threads->collect();
+        alive = handle->threads->aliveCount();
+        break;
+    case kGolEngineCppBits:
+        locs = handle->bits->collect();
+        alive = handle->bits->aliveCount();
+        break;
+    case kGolEngineCppTiled:
+        locs = handle->tiled->collect();
+        alive = handle->tiled->aliveCount();
+        break;
+    case kGolEngineHashLife:
+        locs = handle->hashLife->render();
+        alive = handle->hashLife->aliveCount();
+        break;
+    }
+    if (count) {
+        *count = alive;
+    }
+    return locs;
+}
+
+EXPORT
+const float* gol_update(GolInstance* handle, int64_t* count){
+    const float* locs = nullptr;
+    int64_t alive = 0;
+    int advanced = 1;
+    switch (handle->engine) {
+    case kGolEngineCpp:
+        locs = handle->cpp->update();
+        alive = handle->cpp->aliveCount();
+        break;
+    case kGolEngineCppThreads:
+        locs = handle->threads->update();
+        alive = handle->threads->aliveCount();
+        break;
+    case kGolEngineCppBits:
+        locs = handle->bits->update();
+        alive = handle->bits->aliveCount();
+        break;
+    case kGolEngineCppTiled:
+        locs = handle->tiled->update();
+        alive = handle->tiled->aliveCount();
+        break;
+    case kGolEngineHashLife:
+        advanced = handle->hashLife->step(0) ? 1 : 0;
+        locs = handle->hashLife->render();
+        alive = handle->hashLife->aliveCount();
+        break;
+    }
+    handle->generation += advanced;
+    if (count) {
+        *count = alive;
+    }
+    return locs;
+}
+
+EXPORT
+int gol_update_deltas(GolInstance* handle, const float** born, int64_t* bornCount,
+                      const float** died, int64_t* diedCount){
+    switch (handle->engine) {
+    case kGolEngineCpp:
+        handle->cpp->updateDeltas();
+        *born = handle->cpp->born();
+        *bornCount = handle->cpp->bornCount();
+        *died = handle->cpp->died();
+        *diedCount = handle->cpp->diedCount();
+        break;
+    case kGolEngineCppThreads:
+        handle->threads->updateDeltas();
+        *born = handle->threads->born();
+        *bornCount = handle->threads->bornCount();
+        *died = handle->threads->died();
+        *diedCount = handle->threads->diedCount();
+        break;
+    default:
+        return -1;
+    }
+    handle->generation++;
+    return 0;
+}
+
+EXPORT
+void gol_seed(GolInstance* handle, uint32_t seed, double density){
+    switch (handle->engine) {
+    case kGolEngineCpp: handle->cpp->seed(seed, density); break;
+    case kGolEngineCppThreads: handle->threads->seed(seed, density); break;
+    case kGolEngineCppBits: handle->bits->seed(seed, density); break;
+    case kGolEngineCppTiled: handle->tiled->seed(seed, density); break;
+    case kGolEngineHashLife: handle->hashLife->seed(seed, density); break;
+    }
+    handle->generation = 0;
+}
+
+EXPORT
+void gol_load(GolInstance* handle, const uint8_t* cells){
+    switch (handle->engine) {
+    case kGolEngineCpp: handle->cpp->load(cells); break;
+    case kGolEngineCppThreads: handle->threads->load(cells); break;
+    case kGolEngineCppBits: handle->bits->load(cells); break;
+    case kGolEngineCppTiled: handle->tiled->load(cells); break;
+    case kGolEngineHashLife: handle->hashLife->load(cells); break;
+    }
+    handle->generation = 0;
+}
+
+EXPORT
+void gol_apply_edits(GolInstance* handle, const int32_t* xy, const uint8_t* states, int n){
+    switch (handle->engine) {
+    case kGolEngineCpp: handle->cpp->applyEdits(xy, states, n); break;
+    case kGolEngineCppThreads: handle->threads->applyEdits(xy, states, n); break;
+    case kGolEngineCppBits: handle->bits->applyEdits(xy, states, n); break;
+    case kGolEngineCppTiled: handle->tiled->applyEdits(xy, states, n); break;
+    case kGolEngineHashLife: handle->hashLife->applyEdits(xy, states, n); break;
+    }
+}
+
+EXPORT
+void gol_set_viewport(GolInstance* handle, int x0, int y0, int x1, int y1){
+    switch (handle->engine) {
+    case kGolEngineCpp: handle->cpp->setViewport(x0, y0, x1, y1); break;
+    case kGolEngineCppThreads: handle->threads->setViewport(x0, y0, x1, y1); break;
+    case kGolEngineCppBits: handle->bits->setViewport(x0, y0, x1, y1); break;
+    case kGolEngineCppTiled: handle->tiled->setViewport(x0, y0, x1, y1); break;
+    case kGolEngineHashLife: handle->hashLife->setViewport(x0, y0, x1, y1); break;
+    }
+}
+
+EXPORT
+int gol_set_lod(GolInstance* handle, int level){
+    switch (handle->engine) {
+    case kGolEngineCpp: handle->cpp->setLod(level); return 0;
+    case kGolEngineCppThreads: handle->threads->setLod(level); return 0;
+    }
+    return -1;
+}
+
+EXPORT
+int gol_render(GolInstance* handle, const GolRaster* raster){
+    switch (handle->engine) {
+    case kGolEngineCpp: handle->cpp->render(*raster); return 0;
+    case kGolEngineCppThreads: handle->threads->render(*raster); return 0;
+    case kGolEngineCppTiled: handle->tiled->render(*raster); return 0;
+    }
+    return -1;
+}
+
+EXPORT
+int gol_set_point_format(GolInstance* handle, int format){
+    switch (handle->engine) {
+    case kGolEngineCpp: return handle->cpp->setPointFormat(format) ? 0 : -1;
+    case kGolEngineCppThreads: return handle->threads->setPointFormat(format) ? 0 : -1;
+    }
+    return format == kPointFormatFloats ? 0 : -1;
+}
+
+EXPORT
+int gol_set_boundary(GolInstance* handle, int mode){
+    switch (handle->engine) {
+    case kGolEngineCpp: handle->cpp->setBoundary(mode); return 0;
+    case kGolEngineCppThreads: handle->threads->setBoundary(mode); return 0;
+    case kGolEngineCppBits: handle->bits->setBoundary(mode); return 0;
+    case kGolEngineCppTiled: handle->tiled->setBoundary(mode); return 0;
+    }
+    return -1;
+}
+
+EXPORT
+int gol_point_floats(const GolInstance* handle){
+    switch (handle->engine) {
+    case kGolEngineCpp: return handle->cpp->pointFloats();
+    case kGolEngineCppThreads: return handle->threads->pointFloats();
+    }
+    return 2;
+}
+
+EXPORT
+int gol_lod(const GolInstance* handle){
+    switch (handle->engine) {
+    case kGolEngineCpp: return handle->cpp->lod();
+    case kGolEngineCppThreads: return handle->threads->lod();
+    }
+    return 0;
+}
+
+EXPORT
+uint64_t gol_generation(const GolInstance* handle){
+    return handle->generation;
+}
+
+EXPORT
+void gol_run(GolInstance* handle, double gensPerSecond){
+    if (!handle->runner) {
+        handle->runner = new CppRunner(handle->cells, [handle](int64_t* count, int32_t* pointFloats, int32_t* lod) {
+            *pointFloats = gol_point_floats(handle);
+            *lod = gol_lod(handle);
+            return gol_update(handle, count);
+        });
+    }
+    handle->runner->start(gensPerSecond, handle->generation);
+}
+
+EXPORT
+const float* gol_latest_frame(GolInstance* handle, int64_t* count, int32_t* pointFloats, int32_t* lod,
+                              uint64_t* generation){
+    if (!handle->runner) {
+        if (pointFloats) {
+            *pointFloats = gol_point_floats(handle);
+        }
+        if (lod) {
+            *lod = gol_lod(handle);
+        }
+        if (generation) {
+            *generation = handle->generation;
+        }
+        return gol_collect(handle, count);
+    }
+    return handle->runner->latest(count, pointFloats, lod, generation);
+}
+
+EXPORT
+void gol_stop(GolInstance* handle){
+    if (handle->runner) {
+        handle->runner->stop();
+    }
+}
+
+EXPORT
+void gol_destroy(GolInstance* handle){
+    if (!handle) {
+        return;
+    }
+    delete handle->runner;
+    delete handle->cpp;
+    delete handle->threads;
+    delete handle->bits;
+    delete handle->tiled;
+    delete handle->hashLife;
+    delete handle;
+}
@@ -0,0 +1,129 @@
+//
+#pragma once
+#include <cstdint>
+#include "cppRaster.hpp"
+#include "cppPoints.hpp"
+
+// Handle based C API over the CPU engines. Unlike the per-engine wrappers,
+// which each keep a single global instance, every gol_create returns an
+// independent simulation. Different handles may be used from different
+// threads at the same time; a single handle must not be used from two
+// threads at once.
+
+enum GolEngine
+{
+    kGolEngineCpp = 0,
+    kGolEngineCppThreads = 1,
+    kGolEngineCppBits = 2,
+    kGolEngineCppTiled = 3,
+    kGolEngineHashLife = 4,
+};
+
+struct GolInstance;
+
+extern "C" {
+
+// Creates an engine of the given kind, seeded like the matching initXxx
+// call. numThreads is only used by kGolEngineCppThreads (<= 0 picks the
+// default). Returns nullptr for an unknown engine or a non-positive size.
+GolInstance* gol_create(int engine, int rows, int cols, double cellSize, int numThreads);
+
+// Same as gol_create, but starts from cells (rows * cols, in the given
+// GolCellFormat, see cppSeed.hpp) instead of the legacy random soup. The
+// cells are converted in one pass and not kept.
+GolInstance* gol_create_from(int engine, int rows, int cols, double cellSize, int numThreads,
+                             const void* cells, int format);
+
+// Advances n generations without collecting output. Returns the number of
+// generations actually advanced.
+int gol_step(GolInstance* handle, int n);
+
+// Fills the output buffer from the current generation and returns it;
+// count receives the number of (x, y) points when not null. The buffer is
+// owned by the handle and stays valid until the next call on it; Cpp and
+// CppThreads size it by the population, so it may move between calls.
+const float* gol_collect(GolInstance* handle, int64_t* count);
+
+// One generation followed by gol_collect.
+const float* gol_update(GolInstance* handle, int64_t* count);
+
+// One generation that lists only the cells that changed within the
+// viewport: born and died receive handle-owned buffers of bornCount and
+// diedCount "x, y" points that came alive and died. The gol_collect
+// buffer is not rebuilt. Returns 0, or -1 (without stepping) for engines
+// that do not track changes (CppBits, CppTiled and HashLife).
+int gol_update_deltas(GolInstance* handle, const float** born, int64_t* bornCount,
+                      const float** died, int64_t* diedCount);
+
+// Replaces the grid with a soup from golSeedSoup, or with rows * cols
+// bytes (non-zero = alive). Both restart the generation counter.
+void gol_seed(GolInstance* handle, uint32_t seed, double density);
+void gol_load(GolInstance* handle, const uint8_t* cells);
+
+// Sets or toggles n cells between generations: cell (xy[2i], xy[2i+1])
+// takes GolEdit states[i] (see cppSeed.hpp). Cells outside the grid are
+// ignored.
+void gol_apply_edits(GolInstance* handle, const int32_t* xy, const uint8_t* states, int n);
+
+// Restricts output to the cells in [x0, x1) x [y0, y1), clipped to the
+// grid; gol_collect and gol_update then emit and count only those.
+void gol_set_viewport(GolInstance* handle, int x0, int y0, int x1, int y1);
+
+// Switches gol_collect and gol_update to one weighted point "x, y,
+// weight" per live 2^level x 2^level block (level 1 to 6), see
+// cppDensity.hpp; level 0 goes back to a point per live cell. Counts then
+// count weighted points. Returns 0, or -1 if the engine only has per-cell
+// output (CppBits, CppTiled and HashLife).
+int gol_set_lod(GolInstance* handle, int level);
+
+// Switches the per-cell output of gol_collect and gol_update to format, a
+// GolPointFormat (see cppPoints.hpp): "x, y" float centres, or one packed
+// x | y << 16 word per live cell for consumers that apply the cell size
+// themselves. Density output and gol_update_deltas keep floats. Returns 0,
+// or -1 if the engine only has float output (CppBits, CppTiled and
+// HashLife) or the grid is too large to pack.
+int gol_set_point_format(GolInstance* handle, int format);
+
+// 32-bit words per point of the output: 2 for float centres, 1 for packed
+// cells, or 3 while a density level is set. The buffers are typed float
+// either way.
+int gol_point_floats(const GolInstance* handle);
+
+// Density level of the output set by gol_set_lod, 0 for per-cell output.
+int gol_lod(const GolInstance* handle);
+
+// Draws the current generation into raster's pixel buffer instead of
+// listing live cells, see GolRaster. Returns 0, or -1 if the engine has no
+// raster output (CppBits and HashLife).
+int gol_render(GolInstance* handle, const GolRaster* raster);
+
+// Selects the edge behaviour (see cppBoundary.hpp). Returns 0, or -1 if
+// the engine has no bounded grid (HashLife).
+int gol_set_boundary(GolInstance* handle, int mode);
+
+// Generations advanced since creation or the last seed/load.
+uint64_t gol_generation(const GolInstance* handle);
+
+// Steps the handle on a background thread of its own at gensPerSecond
+// (<= 0: as fast as possible) until gol_stop; calling it again only
+// changes the rate. While it runs, only gol_latest_frame, gol_run,
+// gol_stop and gol_destroy may be used on the handle.
+void gol_run(GolInstance* handle, double gensPerSecond);
+
+// The newest frame the background thread has finished, without waiting
+// for it, or the current generation if gol_run was never called. The
+// frame keeps the layout it was made with: count points of pointFloats
+// words at density level lod, like gol_point_floats and gol_lod at the
+// time. Any out-param may be null; generation counts like gol_generation.
+// Valid until the next call on the handle, and only one thread may call
+// it.
+const float* gol_latest_frame(GolInstance* handle, int64_t* count, int32_t* pointFloats, int32_t* lod,
+                              uint64_t* generation);
+
+// Returns once the background thread has finished its last generation.
+void gol_stop(GolInstance* handle);
+
+// Stops the background thread, if any, and frees the engine.
+void gol_destroy(GolInstance* handle);
+
+}
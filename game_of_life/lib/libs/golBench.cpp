@@ -0,0 +1,270 @@
+// Headless benchmark for the C++ engines. Every engine is driven through
+// the same C ABI the Flutter app uses, so the numbers include the output
+// collection a frame pays for, but none of the timer or painting noise.
+//
+//   gol_bench [--engines cpp,cppThreads,cppBits,cppTiled,hashLife]
+//             [--sizes 256,1024] [--densities 0.1,0.5] [--seeds 1,2]
+//             [--threads 1,2,4] [--gens 200] [--warmup 20]
+//
+// Results go to stdout as one JSON document. Each configuration runs on a
+// fresh instance in a child process of its own, so its peakRssBytes is not
+// inflated by the configurations before it.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern "C" {
+void initCpp(int nRows, int nCols, double cellSize);
+float* updateCpp();
+void seedCpp(uint32_t seed, double density);
+void destructCpp();
+
+void initCppThreadsN(int nRows, int nCols, double cellSize, int numThreads);
+float* updateCppThreads();
+void seedCppThreads(uint32_t seed, double density);
+void destructCppThreads();
+
+void initCppBits(int nRows, int nCols, double cellSize);
+float* updateCppBits();
+void seedCppBits(uint32_t seed, double density);
+void destructCppBits();
+
+void initCppTiled(int nRows, int nCols, double cellSize);
+float* updateCppTiled();
+void seedCppTiled(uint32_t seed, double density);
+void destructCppTiled();
+
+void initHashLife(int nRows, int nCols, double cellSize);
+int stepHashLife(int log2Gens);
+float* renderHashLife();
+void seedHashLife(uint32_t seed, double density);
+void destructHashLife();
+}
+
+static const double kCellSize = 10.0;
+
+struct Engine
+{
+    const char* name;
+    bool threaded;    // Whether the thread count sweep applies
+    void (*init)(int size, int threads);
+    void (*seed)(uint32_t seed, double density);
+    void (*update)();
+    void (*destruct)();
+};
+
+static const Engine kEngines[] = {
+    {"cpp", false,
+     [](int size, int) { initCpp(size, size, kCellSize); },
+     seedCpp, [] { updateCpp(); }, destructCpp},
+    {"cppThreads", true,
+     [](int size, int threads) { initCppThreadsN(size, size, kCellSize, threads); },
+     seedCppThreads, [] { updateCppThreads(); }, destructCppThreads},
+    {"cppBits", false,
+     [](int size, int) { initCppBits(size, size, kCellSize); },
+     seedCppBits, [] { updateCppBits(); }, destructCppBits},
+    {"cppTiled", false,
+     [](int size, int) { initCppTiled(size, size, kCellSize); },
+     seedCppTiled, [] { updateCppTiled(); }, destructCppTiled},
+    // One generation per frame, rendered like the grid engines
+    {"hashLife", false,
+     [](int size, int) { initHashLife(size, size, kCellSize); },
+     seedHashLife, [] { stepHashLife(0); renderHashLife(); }, destructHashLife},
+};
+
+struct Options
+{
+    std::vector<std::string> engines;
+    std::vector<int> sizes = {256, 1024};
+    std::vector<double> densities = {0.1, 0.5};
+    std::vector<int> seeds = {1};
+    std::vector<int> threads = {1, 2, 4};
+    int gens = 200;
+    int warmup = 20;
+};
+
+static std::vector<std::string> splitList(const char* arg)
+{
+    std::vector<std::string> items;
+    std::string item;
+    for (const char* p = arg; ; p++) {
+        if (*p == ',' || *p == '\0') {
+            if (!item.empty()) {
+                items.push_back(item);
+            }
+            item.clear();
+            if (*p == '\0') {
+                break;
+            }
+        } else {
+            item += *p;
+        }
+    }
+    return items;
+}
+
+static std::vector<int> parseInts(const char* arg)
+{
+    std::vector<int> values;
+    for (const std::string& s : splitList(arg)) {
+        values.push_back(atoi(s.c_str()));
+    }
+    return values;
+}
+
+static std::vector<double> parseDoubles(const char* arg)
+{
+    std::vector<double> values;
+    for (const std::string& s : splitList(arg)) {
+        values.push_back(atof(s.c_str()));
+    }
+    return values;
+}
+
+static bool parseArgs(int argc, char** argv, Options& opts)
+{
+    for (int i = 1; i < argc; i++) {
+        const char* flag = argv[i];
+        if (i + 1 >= argc) {
+            fprintf(stderr, "missing value for %s\n", flag);
+            return false;
+        }
+        const char* value = argv[++i];
+        if (!strcmp(flag, "--engines")) {
+            opts.engines = splitList(value);
+        } else if (!strcmp(flag, "--sizes")) {
+            opts.sizes = parseInts(value);
+        } else if (!strcmp(flag, "--densities")) {
+            opts.densities = parseDoubles(value);
+        } else if (!strcmp(flag, "--seeds")) {
+            opts.seeds = parseInts(value);
+        } else if (!strcmp(flag, "--threads")) {
+            opts.threads = parseInts(value);
+        } else if (!strcmp(flag, "--gens")) {
+            opts.gens = atoi(value);
+        } else if (!strcmp(flag, "--warmup")) {
+            opts.warmup = atoi(value);
+        } else {
+            fprintf(stderr, "unknown option %s\n", flag);
+            return false;
+        }
+    }
+    return opts.gens > 0;
+}
+
+static bool isSelected(const Options& opts, const char* name)
+{
+    if (opts.engines.empty()) {
+        return true;
+    }
+    return std::find(opts.engines.begin(), opts.engines.end(), name) != opts.engines.end();
+}
+
+// Peak resident set of this process so far, in bytes. Getrusage only
+// reports the peak, which never goes down, hence a process per
+// configuration.
+static long long peakRssBytes()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return usage.ru_maxrss * 1024LL;
+#endif
+}
+
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+// Measures one configuration on a fresh instance and prints its result,
+// preceded by a comma unless it is the first.
+static void runConfig(const Engine& engine, const Options& opts, int size, int threads, double density, int seed,
+                      bool first)
+{
+    std::vector<double> latencies(opts.gens);
+    engine.init(size, threads);
+    engine.seed((uint32_t)seed, density);
+    for (int g = 0; g < opts.warmup; g++) {
+        engine.update();
+    }
+
+    double total = 0;
+    for (int g = 0; g < opts.gens; g++) {
+        auto start = std::chrono::steady_clock::now();
+        engine.update();
+        auto end = std::chrono::steady_clock::now();
+        latencies[g] = std::chrono::duration<double, std::micro>(end - start).count();
+        total += latencies[g];
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    const double cellsPerSec = (double)size * size * opts.gens / (total * 1e-6);
+    printf("%s\n    {\"engine\": \"%s\", \"rows\": %d, \"cols\": %d, \"threads\": %d, "
+           "\"density\": %g, \"seed\": %d, \"cellsPerSec\": %.6g, "
+           "\"latencyUs\": {\"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}, "
+           "\"peakRssBytes\": %lld}",
+           first ? "" : ",", engine.name, size, size, threads, density, seed, cellsPerSec,
+           total / opts.gens, percentile(latencies, 0.5), percentile(latencies, 0.9),
+           percentile(latencies, 0.99), latencies.back(), peakRssBytes());
+    engine.destruct();
+}
+
+int main(int argc, char** argv)
+{
+    Options opts;
+    if (!parseArgs(argc, argv, opts)) {
+        return 1;
+    }
+
+    printf("{\n  \"gens\": %d,\n  \"warmup\": %d,\n  \"results\": [", opts.gens, opts.warmup);
+    bool first = true;
+
+    for (const Engine& engine : kEngines) {
+        if (!isSelected(opts, engine.name)) {
+            continue;
+        }
+        const std::vector<int> threadCounts = engine.threaded ? opts.threads : std::vector<int>{1};
+        for (int size : opts.sizes) {
+            for (int threads : threadCounts) {
+                for (double density : opts.densities) {
+                    for (int seed : opts.seeds) {
+                        // The child inherits the stdout buffer, so it must be empty
+                        fflush(stdout);
+                        const pid_t child = fork();
+                        if (child < 0) {
+                            perror("fork");
+                            return 1;
+                        }
+                        if (child == 0) {
+                            runConfig(engine, opts, size, threads, density, seed, first);
+                            fflush(stdout);
+                            _exit(0);
+                        }
+                        int status = 0;
+                        waitpid(child, &status, 0);
+                        if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+                            first = false;
+                        } else {
+                            fprintf(stderr, "%s %dx%d, %d threads, density %g, seed %d failed\n",
+                                    engine.name, size, size, threads, density, seed);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
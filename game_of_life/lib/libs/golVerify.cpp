@@ -0,0 +1,727 @@
+// Differential correctness check for the C++ engines. Every engine is run
+// in lockstep with a deliberately simple reference stepper over random
+// soups, known oscillators and edge-heavy patterns, for each boundary mode
+// it supports. After every update the engine's output is turned back into
+// a grid and its hash compared with the reference; the first divergent
+// cell is reported. Each run is repeated with random cell edits applied
+// before every update, the way a pen draws between frames, and with a
+// viewport that moves around the grid, against the reference cells inside
+// it. Engines with density output or born/died deltas have those checked
+// against block sums and against the difference of consecutive reference
+// generations, and those with packed output are run in it as well.
+//
+//   gol_verify [--gens 96] [--engines cpp,cppBlocked,...]
+//
+// Exits with 1 on the first mismatch, so it can gate performance work.
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C" {
+void initCpp(int nRows, int nCols, double cellSize);
+float* updateCountedCpp(int64_t* count);
+float* updateNCpp(int gens);
+int64_t aliveCountCpp();
+void loadCellsCpp(const uint8_t* cells);
+void applyEditsCpp(const int32_t* xy, const uint8_t* states, int n);
+void setViewportCpp(int x0, int y0, int x1, int y1);
+void setLodCpp(int level);
+void updateDeltasCpp(const float** born, int64_t* bornCount, const float** died, int64_t* diedCount);
+int setPointFormatCpp(int format);
+void setBoundaryCpp(int mode);
+void destructCpp();
+
+void initCppThreadsN(int nRows, int nCols, double cellSize, int numThreads);
+float* updateCountedCppThreads(int64_t* count);
+void stepCppThreads(int generations);
+float* collectAliveCppThreads();
+int64_t aliveCountCppThreads();
+void loadCellsCppThreads(const uint8_t* cells);
+void applyEditsCppThreads(const int32_t* xy, const uint8_t* states, int n);
+void setViewportCppThreads(int x0, int y0, int x1, int y1);
+void setLodCppThreads(int level);
+void updateDeltasCppThreads(const float** born, int64_t* bornCount, const float** died, int64_t* diedCount);
+int setPointFormatCppThreads(int format);
+void setBoundaryCppThreads(int mode);
+void destructCppThreads();
+
+void initCppBits(int nRows, int nCols, double cellSize);
+float* updateCountedCppBits(int64_t* count);
+void loadCellsCppBits(const uint8_t* cells);
+void applyEditsCppBits(const int32_t* xy, const uint8_t* states, int n);
+void setViewportCppBits(int x0, int y0, int x1, int y1);
+void setBoundaryCppBits(int mode);
+void destructCppBits();
+
+void initCppTiled(int nRows, int nCols, double cellSize);
+float* updateCountedCppTiled(int64_t* count);
+void loadCellsCppTiled(const uint8_t* cells);
+void applyEditsCppTiled(const int32_t* xy, const uint8_t* states, int n);
+void setViewportCppTiled(int x0, int y0, int x1, int y1);
+void setBoundaryCppTiled(int mode);
+void destructCppTiled();
+
+void initHashLife(int nRows, int nCols, double cellSize);
+int stepHashLife(int log2Gens);
+float* renderHashLife();
+void loadCellsHashLife(const uint8_t* cells);
+void applyEditsHashLife(const int32_t* xy, const uint8_t* states, int n);
+void setViewportHashLife(int x0, int y0, int x1, int y1);
+void destructHashLife();
+}
+
+static const double kCellSize = 10.0;
+
+enum Boundary { kDead = 0, kTorus = 1, kKlein = 2 };
+static const char* kBoundaryNames[] = {"dead", "torus", "klein"};
+
+// GolPointFormat values and the largest side packed cells can address,
+// see cppPoints.hpp.
+static const int kPointFormatFloats = 0;
+static const int kPointFormatCells = 1;
+static const int kMaxPackedCells = 65536;
+
+// Output of one engine update: count points of (x, y) cell centres, of
+// x | y << 16 cell words after kPointFormatCells, or of (x, y, weight)
+// block centres while a density level is set.
+struct Frame
+{
+    const float* points;
+    int64_t count;
+};
+
+struct Engine
+{
+    const char* name;
+    int gensPerUpdate;      // Generations advanced by one update()
+    bool wraps;             // Supports setBoundary
+    bool unbounded;         // Only comparable while patterns stay inside
+    void (*init)(int rows, int cols);
+    void (*load)(const uint8_t* cells);
+    void (*setBoundary)(int mode);
+    void (*applyEdits)(const int32_t* xy, const uint8_t* states, int n);
+    void (*setViewport)(int x0, int y0, int x1, int y1);
+    void (*setLod)(int level);  // Null without density output
+    // One generation, listing only the cells born and died; null where the
+    // engine has no such output or gensPerUpdate is not 1
+    void (*updateDeltas)(const float** born, int64_t* bornCount, const float** died, int64_t* diedCount);
+    int (*setPointFormat)(int format);  // Null with float output only
+    Frame (*update)();
+    void (*destruct)();
+};
+
+static Frame countedFrame(float* (*fn)(int64_t*))
+{
+    int64_t count = 0;
+    const float* points = fn(&count);
+    return {points, count};
+}
+
+static const Engine kEngines[] = {
+    {"cpp", 1, true, false,
+     [](int rows, int cols) { initCpp(rows, cols, kCellSize); },
+     loadCellsCpp, setBoundaryCpp, applyEditsCpp, setViewportCpp, setLodCpp, updateDeltasCpp,
+     setPointFormatCpp,
+     [] { return countedFrame(updateCountedCpp); }, destructCpp},
+    // Temporally blocked path, several generations per call
+    {"cppBlocked", 7, true, false,
+     [](int rows, int cols) { initCpp(rows, cols, kCellSize); },
+     loadCellsCpp, setBoundaryCpp, applyEditsCpp, setViewportCpp, setLodCpp, nullptr,
+     setPointFormatCpp,
+     [] { const float* points = updateNCpp(7); return Frame{points, aliveCountCpp()}; }, destructCpp},
+    {"cppThreads", 1, true, false,
+     [](int rows, int cols) { initCppThreadsN(rows, cols, kCellSize, 3); },
+     loadCellsCppThreads, setBoundaryCppThreads, applyEditsCppThreads, setViewportCppThreads, setLodCppThreads,
+     updateDeltasCppThreads, setPointFormatCppThreads,
+     [] { return countedFrame(updateCountedCppThreads); }, destructCppThreads},
+    // Stepping without output, then a separate collect
+    {"cppThreadsStep", 3, true, false,
+     [](int rows, int cols) { initCppThreadsN(rows, cols, kCellSize, 3); },
+     loadCellsCppThreads, setBoundaryCppThreads, applyEditsCppThreads, setViewportCppThreads, setLodCppThreads,
+     nullptr, setPointFormatCppThreads,
+     [] { stepCppThreads(3); const float* points = collectAliveCppThreads(); return Frame{points, aliveCountCppThreads()}; },
+     destructCppThreads},
+    {"cppBits", 1, true, false,
+     [](int rows, int cols) { initCppBits(rows, cols, kCellSize); },
+     loadCellsCppBits, setBoundaryCppBits, applyEditsCppBits, setViewportCppBits, nullptr, nullptr, nullptr,
+     [] { return countedFrame(updateCountedCppBits); }, destructCppBits},
+    {"cppTiled", 1, true, false,
+     [](int rows, int cols) { initCppTiled(rows, cols, kCellSize); },
+     loadCellsCppTiled, setBoundaryCppTiled, applyEditsCppTiled, setViewportCppTiled, nullptr, nullptr, nullptr,
+     [] { return countedFrame(updateCountedCppTiled); }, destructCppTiled},
+    // 2^2 generations per step; the render is zero terminated
+    {"hashLife", 4, false, true,
+     [](int rows, int cols) { initHashLife(rows, cols, kCellSize); },
+     loadCellsHashLife, nullptr, applyEditsHashLife, setViewportHashLife, nullptr, nullptr, nullptr,
+     [] {
+         stepHashLife(2);
+         const float* points = renderHashLife();
+         int64_t count = 0;
+         while (points[count * 2] != 0 || points[count * 2 + 1] != 0) {
+             count++;
+         }
+         return Frame{points, count};
+     },
+     destructHashLife},
+};
+
+struct Pattern
+{
+    std::string name;
+    int rows;
+    int cols;
+    bool contained;         // Stays well inside the grid for any boundary
+    std::vector<uint8_t> cells;
+};
+
+// Reference stepper: one cell at a time, neighbours mapped through the
+// boundary with plain modular arithmetic.
+static bool refCell(const std::vector<uint8_t>& g, int rows, int cols, int mode, int x, int y)
+{
+    if (y < 0 || y >= rows) {
+        if (mode == kDead) return false;
+        y = (y + rows) % rows;
+        if (mode == kKlein) x = cols - 1 - ((x + cols) % cols);
+    }
+    if (x < 0 || x >= cols) {
+        if (mode == kDead) return false;
+        x = (x + cols) % cols;
+    }
+    return g[y * cols + x] != 0;
+}
+
+static void refStep(std::vector<uint8_t>& g, std::vector<uint8_t>& next, int rows, int cols, int mode)
+{
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            int n = 0;
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    if (dx || dy) {
+                        n += refCell(g, rows, cols, mode, x + dx, y + dy);
+                    }
+                }
+            }
+            next[y * cols + x] = n == 3 || (n == 2 && g[y * cols + x]);
+        }
+    }
+    g.swap(next);
+}
+
+// What a run does on top of stepping, see verify.
+enum Variant { kPlain, kEdits, kViewport, kLod, kDeltas, kPacked, kVariantCount };
+static const char* kVariantNames[] = {"", " / edits", " / viewport", " / lod", " / deltas", " / packed"};
+
+struct Viewport
+{
+    int x0, y0, x1, y1;
+};
+
+// A batch of edits as GolEdit states (0 dead, 1 alive, 2 toggle), some of
+// them outside the grid, where engines must ignore them. For unbounded
+// engines they stay in the middle half of the grid instead.
+struct Edits
+{
+    std::vector<int32_t> xy;
+    std::vector<uint8_t> states;
+};
+
+static Edits randomEdits(std::mt19937& gen, int rows, int cols, bool unbounded)
+{
+    Edits edits;
+    const int n = 1 + gen() % 24;
+    for (int i = 0; i < n; i++) {
+        int x;
+        int y;
+        if (unbounded) {
+            x = cols / 4 + gen() % (cols / 2);
+            y = rows / 4 + gen() % (rows / 2);
+        } else {
+            x = (int)(gen() % (cols + 4)) - 2;
+            y = (int)(gen() % (rows + 4)) - 2;
+        }
+        edits.xy.push_back(x);
+        edits.xy.push_back(y);
+        edits.states.push_back(gen() % 3);
+    }
+    return edits;
+}
+
+static void refApplyEdits(std::vector<uint8_t>& g, int rows, int cols, const Edits& edits)
+{
+    for (size_t i = 0; i < edits.states.size(); i++) {
+        const int x = edits.xy[2 * i];
+        const int y = edits.xy[2 * i + 1];
+        if (x < 0 || y < 0 || x >= cols || y >= rows) {
+            continue;
+        }
+        uint8_t& cell = g[y * cols + x];
+        cell = edits.states[i] == 2 ? !cell : edits.states[i];
+    }
+}
+
+// A viewport somewhere around the grid; it may reach past the edges,
+// which engines clip, or be empty.
+static Viewport randomViewport(std::mt19937& gen, int rows, int cols)
+{
+    Viewport view;
+    view.x0 = (int)(gen() % (cols + 2)) - 1;
+    view.y0 = (int)(gen() % (rows + 2)) - 1;
+    view.x1 = view.x0 + (int)(gen() % (cols + 2));
+    view.y1 = view.y0 + (int)(gen() % (rows + 2));
+    return view;
+}
+
+// Clears the cells of g outside view.
+static void refClip(std::vector<uint8_t>& g, int rows, int cols, const Viewport& view)
+{
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            if (x < view.x0 || y < view.y0 || x >= view.x1 || y >= view.y1) {
+                g[y * cols + x] = 0;
+            }
+        }
+    }
+}
+
+static uint64_t hashGrid(const std::vector<uint8_t>& g)
+{
+    // FNV-1a
+    uint64_t h = 1469598103934665603ull;
+    for (uint8_t v : g) {
+        h = (h ^ v) * 1099511628211ull;
+    }
+    return h;
+}
+
+// Rebuilds a grid from an engine's per-cell output. Returns false (and
+// describes why in error) for points that are not a cell centre or repeat
+// a cell.
+static bool frameToGrid(const Frame& frame, int rows, int cols, bool packed, std::vector<uint8_t>& g,
+                        std::string& error)
+{
+    std::fill(g.begin(), g.end(), 0);
+    for (int i = 0; i < frame.count; i++) {
+        if (packed) {
+            uint32_t word;
+            memcpy(&word, frame.points + i, sizeof(word));
+            const int x = (int)(word & 0xffff);
+            const int y = (int)(word >> 16);
+            if (x >= cols || y >= rows) {
+                char buf[128];
+                snprintf(buf, sizeof(buf), "point %d (%d, %d) is outside the grid", i, x, y);
+                error = buf;
+                return false;
+            }
+            if (g[y * cols + x]) {
+                char buf[128];
+                snprintf(buf, sizeof(buf), "cell (%d, %d) is reported twice", x, y);
+                error = buf;
+                return false;
+            }
+            g[y * cols + x] = 1;
+            continue;
+        }
+        const double fx = frame.points[i * 2] / kCellSize - 0.5;
+        const double fy = frame.points[i * 2 + 1] / kCellSize - 0.5;
+        const int x = (int)(fx + 0.5);
+        const int y = (int)(fy + 0.5);
+        if (x < 0 || x >= cols || y < 0 || y >= rows || x != fx || y != fy) {
+            char buf[128];
+            snprintf(buf, sizeof(buf), "point %d (%g, %g) is not a cell centre", i,
+                     frame.points[i * 2], frame.points[i * 2 + 1]);
+            error = buf;
+            return false;
+        }
+        if (g[y * cols + x]) {
+            char buf[128];
+            snprintf(buf, sizeof(buf), "cell (%d, %d) is reported twice", x, y);
+            error = buf;
+            return false;
+        }
+        g[y * cols + x] = 1;
+    }
+    return true;
+}
+
+// Checks per-cell output, packed or not, against the expected grid, using
+// actual as scratch. Returns false and describes the first difference in
+// error.
+static bool checkCells(const Frame& frame, const std::vector<uint8_t>& expected, int rows, int cols, bool packed,
+                       std::vector<uint8_t>& actual, std::string& error)
+{
+    if (!frameToGrid(frame, rows, cols, packed, actual, error)) {
+        return false;
+    }
+    if (hashGrid(actual) == hashGrid(expected)) {
+        return true;
+    }
+    size_t i = 0;
+    while (i < expected.size() && expected[i] == actual[i]) {
+        i++;
+    }
+    char buf[128];
+    snprintf(buf, sizeof(buf), "first divergent cell (%d, %d), expected %d, got %d", (int)(i % cols),
+             (int)(i / cols), expected[i], actual[i]);
+    error = buf;
+    return false;
+}
+
+// Checks density output at level against block sums of the expected grid:
+// one point per block with live cells, at the block's centre, weighted by
+// the fraction of its cells alive. Blocks are aligned to the grid, so
+// those cut by the viewport only count the cells inside it.
+static bool checkDensity(const Frame& frame, const std::vector<uint8_t>& expected, int rows, int cols, int level,
+                         std::string& error)
+{
+    const int size = 1 << level;
+    const int blocksX = (cols + size - 1) >> level;
+    const int blocksY = (rows + size - 1) >> level;
+    std::vector<int> sums(blocksX * blocksY, 0);
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            sums[(y >> level) * blocksX + (x >> level)] += expected[y * cols + x];
+        }
+    }
+    const float blockSize = (float)size * (float)kCellSize;
+    const float weightScale = 1.0f / (float)(size * size);
+    std::vector<uint8_t> seen(sums.size(), 0);
+    char buf[160];
+    for (int i = 0; i < frame.count; i++) {
+        const float* p = frame.points + i * 3;
+        const int bx = (int)(p[0] / blockSize);
+        const int by = (int)(p[1] / blockSize);
+        if (bx < 0 || by < 0 || bx >= blocksX || by >= blocksY || p[0] != (bx + 0.5f) * blockSize ||
+            p[1] != (by + 0.5f) * blockSize) {
+            snprintf(buf, sizeof(buf), "point %d (%g, %g) is not a block centre", i, p[0], p[1]);
+            error = buf;
+            return false;
+        }
+        const int b = by * blocksX + bx;
+        if (seen[b]) {
+            snprintf(buf, sizeof(buf), "block (%d, %d) is reported twice", bx, by);
+            error = buf;
+            return false;
+        }
+        seen[b] = 1;
+        if (p[2] != sums[b] * weightScale) {
+            snprintf(buf, sizeof(buf), "block (%d, %d) has weight %g, expected %g", bx, by, p[2],
+                     sums[b] * weightScale);
+            error = buf;
+            return false;
+        }
+    }
+    for (size_t b = 0; b < sums.size(); b++) {
+        if (sums[b] && !seen[b]) {
+            snprintf(buf, sizeof(buf), "block (%d, %d) with %d live cells is missing", (int)(b % blocksX),
+                     (int)(b / blocksX), sums[b]);
+            error = buf;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void place(Pattern& p, int x0, int y0, const char* const* rowsText, int n)
+{
+    for (int y = 0; y < n; y++) {
+        for (int x = 0; rowsText[y][x]; x++) {
+            if (rowsText[y][x] == 'O') {
+                p.cells[(y0 + y) * p.cols + x0 + x] = 1;
+            }
+        }
+    }
+}
+
+static Pattern emptyPattern(const std::string& name, int rows, int cols, bool contained)
+{
+    return Pattern{name, rows, cols, contained, std::vector<uint8_t>(rows * cols, 0)};
+}
+
+static std::vector<Pattern> makePatterns()
+{
+    std::vector<Pattern> patterns;
+
+    // Random soups, including sizes that are not multiples of any tile,
+    // word or SIMD width
+    const int soupShapes[][2] = {{64, 64}, {67, 130}, {129, 257}, {5, 300}, {300, 3}};
+    const double densities[] = {0.15, 0.5};
+    uint32_t seed = 1;
+    for (auto& shape : soupShapes) {
+        for (double density : densities) {
+            char name[64];
+            snprintf(name, sizeof(name), "soup %dx%d d=%.2f", shape[0], shape[1], density);
+            Pattern p = emptyPattern(name, shape[0], shape[1], false);
+            std::mt19937 gen(seed++);
+            std::uniform_real_distribution<double> uniform(0.0, 1.0);
+            for (uint8_t& c : p.cells) {
+                c = uniform(gen) < density;
+            }
+            patterns.push_back(p);
+        }
+    }
+
+    // Oscillators with known periods, well away from the edges
+    static const char* const blinker[] = {"OOO"};
+    static const char* const toad[] = {".OOO", "OOO."};
+    static const char* const beacon[] = {"OO..", "OO..", "..OO", "..OO"};
+    static const char* const pulsar[] = {
+        "..OOO...OOO..", ".............", "O....O.O....O", "O....O.O....O",
+        "O....O.O....O", "..OOO...OOO..", ".............", "..OOO...OOO..",
+        "O....O.O....O", "O....O.O....O", "O....O.O....O", ".............",
+        "..OOO...OOO.."};
+    static const char* const pentadecathlon[] = {"..O....O..", "OO.OOOO.OO", "..O....O.."};
+    Pattern osc = emptyPattern("oscillators", 64, 96, true);
+    place(osc, 8, 8, blinker, 1);
+    place(osc, 20, 8, toad, 2);
+    place(osc, 32, 8, beacon, 4);
+    place(osc, 10, 24, pulsar, 13);
+    place(osc, 40, 30, pentadecathlon, 3);
+    patterns.push_back(osc);
+
+    // Gliders heading for every edge and corner
+    static const char* const gliderSE[] = {".O.", "..O", "OOO"};
+    static const char* const gliderNW[] = {"OOO", "O..", ".O."};
+    static const char* const gliderNE[] = {"OOO", "..O", ".O."};
+    static const char* const gliderSW[] = {".O.", "O..", "OOO"};
+    Pattern gliders = emptyPattern("gliders", 40, 50, false);
+    place(gliders, 30, 30, gliderSE, 3);
+    place(gliders, 5, 5, gliderNW, 3);
+    place(gliders, 40, 4, gliderNE, 3);
+    place(gliders, 4, 32, gliderSW, 3);
+    patterns.push_back(gliders);
+
+    // A lone glider crossing a corner of a grid several tiles wide, so the
+    // tiles it wraps into have been idle
+    Pattern crossing = emptyPattern("corner crossing", 200, 300, false);
+    place(crossing, 3, 3, gliderNW, 3);
+    patterns.push_back(crossing);
+
+    // Edge-heavy: a random band three cells deep along every border, and
+    // a full frame with corners set
+    Pattern band = emptyPattern("edge band", 70, 131, false);
+    std::mt19937 gen(99);
+    for (int y = 0; y < band.rows; y++) {
+        for (int x = 0; x < band.cols; x++) {
+            const bool edge = x < 3 || y < 3 || x >= band.cols - 3 || y >= band.rows - 3;
+            band.cells[y * band.cols + x] = edge && (gen() & 1);
+        }
+    }
+    patterns.push_back(band);
+
+    Pattern frame = emptyPattern("edge frame", 33, 65, false);
+    for (int y = 0; y < frame.rows; y++) {
+        for (int x = 0; x < frame.cols; x++) {
+            frame.cells[y * frame.cols + x] = x == 0 || y == 0 || x == frame.cols - 1 || y == frame.rows - 1;
+        }
+    }
+    patterns.push_back(frame);
+
+    return patterns;
+}
+
+// Runs engine against the reference on one pattern: kEdits applies random
+// edits before every update, kViewport moves the viewport every few
+// updates and expects only the cells inside it, kLod does the same while
+// switching density levels, 0 included, and kDeltas does it with three
+// updateDeltas calls for every full update, whose born and died lists
+// must match the difference of consecutive reference generations. kPacked
+// moves the viewport like kViewport over kPointFormatCells output. Returns
+// false after printing the first divergence.
+static bool verify(const Engine& engine, const Pattern& pattern, int mode, int gens, Variant variant)
+{
+    const bool edit = variant == kEdits;
+    const bool packed = variant == kPacked;
+    std::mt19937 editGen((uint32_t)hashGrid(pattern.cells) + mode);
+    Viewport view{0, 0, pattern.cols, pattern.rows};
+    int lod = 0;
+    std::vector<uint8_t> expected(pattern.cells.size());
+    if (edit && engine.unbounded) {
+        // Nothing an edit starts can leave the grid in this many generations
+        gens = std::min(gens, std::min(pattern.rows, pattern.cols) / 4);
+    }
+    std::vector<uint8_t> ref = pattern.cells;
+    std::vector<uint8_t> prev(ref.size());
+    std::vector<uint8_t> scratch(ref.size());
+    std::vector<uint8_t> actual(ref.size());
+
+    engine.init(pattern.rows, pattern.cols);
+    engine.load(pattern.cells.data());
+    if (engine.setBoundary) {
+        engine.setBoundary(mode);
+    }
+    if (packed && engine.setPointFormat(kPointFormatCells) != 0) {
+        printf("FAIL %s / %s: packed output refused on a %dx%d grid\n", engine.name, pattern.name.c_str(),
+               pattern.rows, pattern.cols);
+        engine.destruct();
+        return false;
+    }
+
+    bool ok = true;
+    for (int gen = engine.gensPerUpdate; gen <= gens && ok; gen += engine.gensPerUpdate) {
+        if (edit) {
+            const Edits edits = randomEdits(editGen, pattern.rows, pattern.cols, engine.unbounded);
+            refApplyEdits(ref, pattern.rows, pattern.cols, edits);
+            engine.applyEdits(edits.xy.data(), edits.states.data(), (int)edits.states.size());
+        }
+        prev = ref;
+        for (int g = 0; g < engine.gensPerUpdate; g++) {
+            refStep(ref, scratch, pattern.rows, pattern.cols, mode);
+        }
+        const int update = gen / engine.gensPerUpdate;
+        if (((variant == kViewport || variant == kDeltas || packed) && update % 5 == 1) || (variant == kLod && update % 7 == 1)) {
+            // Level runs keep the full grid half of the time
+            view = variant == kLod && (editGen() & 1) ? Viewport{0, 0, pattern.cols, pattern.rows}
+                                                       : randomViewport(editGen, pattern.rows, pattern.cols);
+            engine.setViewport(view.x0, view.y0, view.x1, view.y1);
+        }
+        if (variant == kLod && update % 3 == 1) {
+            lod = editGen() % 7;
+            engine.setLod(lod);
+        }
+        std::string error;
+        bool match = true;
+        if (variant == kDeltas && update % 4 != 0) {
+            Frame born{};
+            Frame died{};
+            engine.updateDeltas(&born.points, &born.count, &died.points, &died.count);
+            for (size_t i = 0; i < ref.size(); i++) {
+                expected[i] = ref[i] && !prev[i];
+            }
+            refClip(expected, pattern.rows, pattern.cols, view);
+            match = checkCells(born, expected, pattern.rows, pattern.cols, false, actual, error);
+            if (match) {
+                for (size_t i = 0; i < ref.size(); i++) {
+                    expected[i] = prev[i] && !ref[i];
+                }
+                refClip(expected, pattern.rows, pattern.cols, view);
+                match = checkCells(died, expected, pattern.rows, pattern.cols, false, actual, error);
+                error = "died: " + error;
+            } else {
+                error = "born: " + error;
+            }
+        } else {
+            Frame frame = engine.update();
+            expected = ref;
+            refClip(expected, pattern.rows, pattern.cols, view);
+            match = lod ? checkDensity(frame, expected, pattern.rows, pattern.cols, lod, error)
+                        : checkCells(frame, expected, pattern.rows, pattern.cols, packed, actual, error);
+        }
+        if (!match) {
+            printf("FAIL %s / %s / %s%s: generation %d: %s\n", engine.name, pattern.name.c_str(),
+                   kBoundaryNames[mode], kVariantNames[variant], gen, error.c_str());
+            ok = false;
+        }
+    }
+    engine.destruct();
+    if (ok) {
+        printf("ok   %s / %s / %s%s\n", engine.name, pattern.name.c_str(), kBoundaryNames[mode], kVariantNames[variant]);
+    }
+    return ok;
+}
+
+// Packed cells must reach the last row and column a 16-bit coordinate can
+// hold, and be refused, leaving float output, one cell past it. A block
+// still life in the far corner of 2 x kMaxPackedCells and kMaxPackedCells x
+// 2 grids has to come back as those coordinates.
+static bool verifyPackedLimit(const Engine& engine)
+{
+    const int shapes[][2] = {{2, kMaxPackedCells}, {kMaxPackedCells, 2}, {1, kMaxPackedCells + 1},
+                             {kMaxPackedCells + 1, 1}};
+    for (const auto& shape : shapes) {
+        const int rows = shape[0];
+        const int cols = shape[1];
+        const bool fits = rows <= kMaxPackedCells && cols <= kMaxPackedCells;
+        std::vector<uint8_t> cells((size_t)rows * cols, 0);
+        if (fits) {
+            for (int y = rows - 2; y < rows; y++) {
+                for (int x = cols - 2; x < cols; x++) {
+                    cells[(size_t)y * cols + x] = 1;
+                }
+            }
+        }
+        engine.init(rows, cols);
+        engine.load(cells.data());
+        const int result = engine.setPointFormat(kPointFormatCells);
+        std::string error;
+        bool ok = result == (fits ? 0 : -1);
+        if (!ok) {
+            error = fits ? "packed output refused" : "packed output accepted";
+        } else if (fits) {
+            std::vector<uint8_t> actual(cells.size());
+            ok = checkCells(engine.update(), cells, rows, cols, true, actual, error);
+        } else if (engine.setPointFormat(kPointFormatFloats) != 0) {
+            ok = false;
+            error = "float output refused after the packed refusal";
+        }
+        engine.destruct();
+        if (!ok) {
+            printf("FAIL %s / packed limit %dx%d: %s\n", engine.name, rows, cols, error.c_str());
+            return false;
+        }
+    }
+    printf("ok   %s / packed limit\n", engine.name);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    int gens = 96;
+    std::vector<std::string> selected;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--gens")) {
+            gens = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "--engines")) {
+            std::string list = argv[i + 1];
+            size_t start = 0;
+            while (start <= list.size()) {
+                size_t end = list.find(',', start);
+                if (end == std::string::npos) end = list.size();
+                selected.push_back(list.substr(start, end - start));
+                start = end + 1;
+            }
+        } else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    const std::vector<Pattern> patterns = makePatterns();
+    int checked = 0;
+    for (const Engine& engine : kEngines) {
+        if (!selected.empty() && std::find(selected.begin(), selected.end(), engine.name) == selected.end()) {
+            continue;
+        }
+        if (engine.setPointFormat) {
+            if (!verifyPackedLimit(engine)) {
+                return 1;
+            }
+            checked++;
+        }
+        for (const Pattern& pattern : patterns) {
+            if (engine.unbounded && !pattern.contained) {
+                continue;
+            }
+            const int modes = engine.wraps ? 3 : 1;
+            for (int mode = 0; mode < modes; mode++) {
+                for (int variant = kPlain; variant < kVariantCount; variant++) {
+                    if ((variant == kLod && !engine.setLod) || (variant == kDeltas && !engine.updateDeltas) ||
+                        (variant == kPacked && !engine.setPointFormat)) {
+                        continue;
+                    }
+                    if (!verify(engine, pattern, mode, gens, (Variant)variant)) {
+                        return 1;
+                    }
+                    checked++;
+                }
+            }
+        }
+    }
+    printf("%d runs agree with the reference\n", checked);
+    return 0;
+}
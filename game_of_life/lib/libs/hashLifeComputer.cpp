@@ -0,0 +1,537 @@
+#include "hashLifeComputer.hpp"
+#include "cppSeed.hpp"
+#include "cppViewport.hpp"
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
+
+// Nodes are allocated in blocks of this many and recycled through a free list.
+static const size_t kBlockSize = 1 << 16;
+// Garbage is collected between steps once this many nodes are live.
+static const size_t kMaxNodes = 1 << 21;
+// Largest root. Its cells then span [-2^61, 2^61), so every coordinate and
+// node size stays within int64_t.
+static const int kMaxLevel = 62;
+// Largest step: the root must be two levels above the step plus one level
+// of margin.
+static const int kMaxStepLog2 = kMaxLevel - 3;
+
+HashLifeComputer::HashLifeComputer(int32_t nRows, int32_t nCols, double cellSize, const void* cells, int format)
+: rows(nRows), cols(nCols), cellSize(cellSize)
+{
+    m_alive.population = 1;
+    m_gcThreshold = kMaxNodes;
+    m_buckets.assign(1 << 16, nullptr);
+    m_view = golFullViewport(rows, cols);
+    initData(cells, format);
+}
+
+HashLifeComputer::~HashLifeComputer()
+{
+    for (Node* block : m_blocks) {
+        delete[] block;
+    }
+    delete[] m_pAliveLocs;
+}
+
+// Starts from cells when given, see load, and from the legacy soup
+// otherwise.
+void HashLifeComputer::initData(const void* cells, int format)
+{
+    if (cells) {
+        load(cells, format);
+        return;
+    }
+
+    // Same soup as CppComputer
+    const int64_t count = (int64_t)rows * cols;
+    uint8_t* grid = new uint8_t[count];
+    srand(7);
+    for (int64_t i = 0; i < count; ++i)
+    {
+        grid[i] = rand() % 2;
+    }
+    buildRoot(grid);
+    delete[] grid;
+}
+
+// Replaces the universe with grid (rows x cols) at generation 0. Nodes of
+// the old universe are left to the next collection.
+void HashLifeComputer::buildRoot(const uint8_t* grid)
+{
+    // Root is centred on the origin, so it covers [-2^(level-1), 2^(level-1))
+    int level = 3;
+    while ((int64_t(1) << (level - 1)) < rows || (int64_t(1) << (level - 1)) < cols) {
+        level++;
+    }
+    int64_t half = int64_t(1) << (level - 1);
+    m_pRoot = buildFromGrid(grid, level, -half, -half);
+    m_generation = 0;
+}
+
+// Replaces the universe with cells, rows * cols cells in the given
+// GolCellFormat. Bytes are read in place; the other formats are converted
+// first.
+void HashLifeComputer::load(const void* cells, int format)
+{
+    if (format == kCellFormatBytes) {
+        buildRoot((const uint8_t*)cells);
+        return;
+    }
+    uint8_t* grid = new uint8_t[(int64_t)rows * cols];
+    golImportCells(grid, rows, cols, cols, cells, format);
+    buildRoot(grid);
+    delete[] grid;
+}
+
+// Replaces the universe with a soup of the given density, see golSeedSoup.
+void HashLifeComputer::seed(uint32_t seed, double density)
+{
+    uint8_t* grid = new uint8_t[(int64_t)rows * cols];
+    golSeedSoup(grid, rows, cols, cols, seed, density);
+    buildRoot(grid);
+    delete[] grid;
+}
+
+// Applies n edits between generations: cell (xy[2i], xy[2i+1]) of the
+// render window takes GolEdit states[i]. Cells outside the window are
+// ignored. Each edit rebuilds only the path from the root to the cell;
+// every other macrocell, and its memoized future, is shared as before.
+void HashLifeComputer::applyEdits(const int32_t* xy, const uint8_t* states, int n)
+{
+    for (int i = 0; i < n; i++) {
+        const int x = xy[2 * i];
+        const int y = xy[2 * i + 1];
+        if (x < 0 || y < 0 || x >= cols || y >= rows) {
+            continue;
+        }
+        const int64_t half = int64_t(1) << (m_pRoot->level - 1);
+        m_pRoot = setCell(m_pRoot, x + half, y + half, states[i]);
+    }
+}
+
+// Returns n with the cell at (x, y), relative to n's top left corner,
+// edited.
+HashLifeComputer::Node* HashLifeComputer::setCell(Node* n, int64_t x, int64_t y, uint8_t edit)
+{
+    if (n->level == 0) {
+        return golEditedCell(n == &m_alive, edit) ? &m_alive : &m_dead;
+    }
+    const int64_t half = int64_t(1) << (n->level - 1);
+    Node* nw = n->nw;
+    Node* ne = n->ne;
+    Node* sw = n->sw;
+    Node* se = n->se;
+    if (y < half) {
+        if (x < half) {
+            nw = setCell(nw, x, y, edit);
+        } else {
+            ne = setCell(ne, x - half, y, edit);
+        }
+    } else {
+        if (x < half) {
+            sw = setCell(sw, x, y - half, edit);
+        } else {
+            se = setCell(se, x - half, y - half, edit);
+        }
+    }
+    return find(nw, ne, sw, se);
+}
+
+HashLifeComputer::Node* HashLifeComputer::buildFromGrid(const uint8_t* grid, int level, int64_t x0, int64_t y0)
+{
+    int64_t size = int64_t(1) << level;
+    if (x0 >= cols || y0 >= rows || x0 + size <= 0 || y0 + size <= 0) {
+        return empty(level);
+    }
+    if (level == 0) {
+        return grid[y0 * cols + x0] ? &m_alive : &m_dead;
+    }
+    int64_t half = size / 2;
+    return find(buildFromGrid(grid, level - 1, x0, y0),
+                buildFromGrid(grid, level - 1, x0 + half, y0),
+                buildFromGrid(grid, level - 1, x0, y0 + half),
+                buildFromGrid(grid, level - 1, x0 + half, y0 + half));
+}
+
+// Advances the universe by 2^log2Gens generations. Returns false, without
+// stepping, if log2Gens is over kMaxStepLog2 or the pattern has spread so
+// far that the universe would outgrow kMaxLevel.
+bool HashLifeComputer::step(int log2Gens)
+{
+    if (log2Gens < 0) {
+        log2Gens = 0;
+    }
+    if (log2Gens > kMaxStepLog2) {
+        return false;
+    }
+
+    // The result of a level k node is its centre half, so grow the universe
+    // until the pattern sits in the middle quarter and the node is big enough
+    // to be advanced 2^log2Gens at once, plus one level of margin.
+    // Expanding keeps the universe the same, so giving up half way is safe.
+    while (m_pRoot->level < log2Gens + 2 || !isPadded(m_pRoot)) {
+        if (m_pRoot->level + 1 >= kMaxLevel) {
+            return false;
+        }
+        m_pRoot = expand(m_pRoot);
+    }
+    m_pRoot = expand(m_pRoot);
+    m_pRoot = advance(m_pRoot, log2Gens);
+    m_generation += uint64_t(1) << log2Gens;
+
+    if (m_nodeCount > m_gcThreshold) {
+        collectGarbage();
+        // Avoid collecting every step when the live set itself is large
+        m_gcThreshold = m_nodeCount * 2 > kMaxNodes ? m_nodeCount * 2 : kMaxNodes;
+    }
+    return true;
+}
+
+// Limits output points to the cells in [x0, x1) x [y0, y1), clipped to
+// the grid. Takes effect from the next render.
+void HashLifeComputer::setViewport(int x0, int y0, int x1, int y1)
+{
+    m_view = golClampViewport(x0, y0, x1, y1, rows, cols);
+}
+
+// Lists the live cells in the viewport. The output is sized by the
+// population the viewport actually shows, which the quadtree gives without
+// visiting any cell, rather than by the window.
+float* HashLifeComputer::render()
+{
+    int64_t k = 0;
+    const float halfCell = cellSize * 0.5f;
+    int64_t half = int64_t(1) << (m_pRoot->level - 1);
+    reserveAlive(viewPopulation(m_pRoot, -half, -half) * 2 + 2, 0);
+    renderNode(m_pRoot, -half, -half, k, halfCell);
+    setAliveCount(k);
+
+    return m_pAliveLocs;
+}
+
+// Records k floats as this render's output and zeroes what is left of a
+// larger previous one, so the buffer stays (0, 0) terminated.
+void HashLifeComputer::setAliveCount(int64_t k)
+{
+    reserveAlive(k + 2, k);
+    if (k < m_aliveCount * 2) {
+        memset(m_pAliveLocs + k, 0, (m_aliveCount * 2 - k) * sizeof(float));
+    }
+    m_aliveCount = k / 2;
+}
+
+// Makes room for need floats in m_pAliveLocs, keeping the first keep, see
+// golReservePoints.
+void HashLifeComputer::reserveAlive(int64_t need, int64_t keep)
+{
+    golReservePoints(m_pAliveLocs, m_aliveCapacity, need, keep, (int64_t)rows * cols * 2 + 2);
+}
+
+// Live cells of n, whose top left cell is at (x0, y0), inside the viewport.
+// Only nodes cut by the viewport's edges are split.
+int64_t HashLifeComputer::viewPopulation(Node* n, int64_t x0, int64_t y0)
+{
+    int64_t size = int64_t(1) << n->level;
+    if (n->population == 0 || x0 >= m_view.x1 || y0 >= m_view.y1 ||
+        x0 + size <= m_view.x0 || y0 + size <= m_view.y0) {
+        return 0;
+    }
+    if (x0 >= m_view.x0 && y0 >= m_view.y0 && x0 + size <= m_view.x1 && y0 + size <= m_view.y1) {
+        return (int64_t)n->population;
+    }
+    int64_t half = size / 2;
+    return viewPopulation(n->nw, x0, y0) + viewPopulation(n->ne, x0 + half, y0) +
+           viewPopulation(n->sw, x0, y0 + half) + viewPopulation(n->se, x0 + half, y0 + half);
+}
+
+void HashLifeComputer::renderNode(Node* n, int64_t x0, int64_t y0, int64_t& k, float halfCell)
+{
+    int64_t size = int64_t(1) << n->level;
+    if (n->population == 0 || x0 >= m_view.x1 || y0 >= m_view.y1 ||
+        x0 + size <= m_view.x0 || y0 + size <= m_view.y0) {
+        return;
+    }
+    if (n->level == 0) {
+        m_pAliveLocs[k++] = x0 * cellSize + halfCell;
+        m_pAliveLocs[k++] = y0 * cellSize + halfCell;
+        return;
+    }
+    int64_t half = size / 2;
+    renderNode(n->nw, x0, y0, k, halfCell);
+    renderNode(n->ne, x0 + half, y0, k, halfCell);
+    renderNode(n->sw, x0, y0 + half, k, halfCell);
+    renderNode(n->se, x0 + half, y0 + half, k, halfCell);
+}
+
+HashLifeComputer::Node* HashLifeComputer::allocNode()
+{
+    if (!m_pFreeList) {
+        Node* block = new Node[kBlockSize];
+        m_blocks.push_back(block);
+        for (size_t i = 0; i < kBlockSize; i++) {
+            block[i].hashNext = m_pFreeList;
+            m_pFreeList = &block[i];
+        }
+    }
+    Node* n = m_pFreeList;
+    m_pFreeList = n->hashNext;
+    return n;
+}
+
+static inline size_t hashChildren(const void* nw, const void* ne, const void* sw, const void* se)
+{
+    size_t h = (size_t)nw;
+    h = h * 1000003u ^ (size_t)ne;
+    h = h * 1000003u ^ (size_t)sw;
+    h = h * 1000003u ^ (size_t)se;
+    return h ^ (h >> 17);
+}
+
+// Returns the canonical node with these four quadrants, creating it if needed.
+HashLifeComputer::Node* HashLifeComputer::find(Node* nw, Node* ne, Node* sw, Node* se)
+{
+    size_t bucket = hashChildren(nw, ne, sw, se) & (m_buckets.size() - 1);
+    for (Node* n = m_buckets[bucket]; n; n = n->hashNext) {
+        if (n->nw == nw && n->ne == ne && n->sw == sw && n->se == se) {
+            return n;
+        }
+    }
+
+    Node* n = allocNode();
+    n->nw = nw;
+    n->ne = ne;
+    n->sw = sw;
+    n->se = se;
+    n->result = nullptr;
+    n->slowResult = nullptr;
+    n->slowLog2 = -1;
+    n->population = nw->population + ne->population + sw->population + se->population;
+    n->level = nw->level + 1;
+    n->marked = false;
+    n->hashNext = m_buckets[bucket];
+    m_buckets[bucket] = n;
+
+    if (++m_nodeCount > m_buckets.size() - m_buckets.size() / 4) {
+        rehash(m_buckets.size() * 2);
+    }
+    return n;
+}
+
+void HashLifeComputer::rehash(size_t bucketCount)
+{
+    std::vector<Node*> buckets(bucketCount, nullptr);
+    for (Node* head : m_buckets) {
+        while (head) {
+            Node* next = head->hashNext;
+            size_t bucket = hashChildren(head->nw, head->ne, head->sw, head->se) & (bucketCount - 1);
+            head->hashNext = buckets[bucket];
+            buckets[bucket] = head;
+            head = next;
+        }
+    }
+    m_buckets.swap(buckets);
+}
+
+HashLifeComputer::Node* HashLifeComputer::empty(int level)
+{
+    if (level == 0) {
+        return &m_dead;
+    }
+    while ((int)m_empty.size() <= level) {
+        m_empty.push_back(nullptr);
+    }
+    if (!m_empty[level]) {
+        Node* e = empty(level - 1);
+        m_empty[level] = find(e, e, e, e);
+    }
+    return m_empty[level];
+}
+
+// Doubles the node around its own centre.
+HashLifeComputer::Node* HashLifeComputer::expand(Node* n)
+{
+    Node* e = empty(n->level - 1);
+    return find(find(e, e, e, n->nw),
+                find(e, e, n->ne, e),
+                find(e, n->sw, e, e),
+                find(n->se, e, e, e));
+}
+
+// True when all live cells are inside the middle quarter of the node.
+bool HashLifeComputer::isPadded(Node* n)
+{
+    return n->level >= 3 &&
+           n->nw->population == n->nw->se->se->population &&
+           n->ne->population == n->ne->sw->sw->population &&
+           n->sw->population == n->sw->ne->ne->population &&
+           n->se->population == n->se->nw->nw->population;
+}
+
+HashLifeComputer::Node* HashLifeComputer::centre(Node* n)
+{
+    return find(n->nw->se, n->ne->sw, n->sw->ne, n->se->nw);
+}
+
+// Returns the centre half of n advanced 2^min(log2Gens, level-2) generations.
+// Every step of at least 2^(level-2) gives the same full-step result, so
+// only nodes above the step size keep a separate result for it; mixing
+// step sizes then leaves the bulk of the memo, the small nodes, intact.
+HashLifeComputer::Node* HashLifeComputer::advance(Node* n, int log2Gens)
+{
+    if (n->population == 0) {
+        return empty(n->level - 1);
+    }
+    const bool fullStep = log2Gens >= n->level - 2;
+    if (fullStep && n->result) {
+        return n->result;
+    }
+    if (!fullStep && n->slowResult && n->slowLog2 == log2Gens) {
+        return n->slowResult;
+    }
+    if (n->level == 2) {
+        n->result = advanceBase(n);
+        return n->result;
+    }
+
+    Node* nw = n->nw;
+    Node* ne = n->ne;
+    Node* sw = n->sw;
+    Node* se = n->se;
+
+    // Nine overlapping subnodes of level-1 tiling the node
+    Node* n00 = nw;
+    Node* n01 = find(nw->ne, ne->nw, nw->se, ne->sw);
+    Node* n02 = ne;
+    Node* n10 = find(nw->sw, nw->se, sw->nw, sw->ne);
+    Node* n11 = find(nw->se, ne->sw, sw->ne, se->nw);
+    Node* n12 = find(ne->sw, ne->se, se->nw, se->ne);
+    Node* n20 = sw;
+    Node* n21 = find(sw->ne, se->nw, sw->se, se->sw);
+    Node* n22 = se;
+
+    Node *r00, *r01, *r02, *r10, *r11, *r12, *r20, *r21, *r22;
+    int next = log2Gens;
+    if (fullStep) {
+        // Full speed: two half-steps of 2^(level-3) each
+        next = n->level - 3;
+        r00 = advance(n00, next);
+        r01 = advance(n01, next);
+        r02 = advance(n02, next);
+        r10 = advance(n10, next);
+        r11 = advance(n11, next);
+        r12 = advance(n12, next);
+        r20 = advance(n20, next);
+        r21 = advance(n21, next);
+        r22 = advance(n22, next);
+    } else {
+        // Smaller step: only the second round advances time
+        r00 = centre(n00);
+        r01 = centre(n01);
+        r02 = centre(n02);
+        r10 = centre(n10);
+        r11 = centre(n11);
+        r12 = centre(n12);
+        r20 = centre(n20);
+        r21 = centre(n21);
+        r22 = centre(n22);
+    }
+
+    Node* result = find(advance(find(r00, r01, r10, r11), next),
+                        advance(find(r01, r02, r11, r12), next),
+                        advance(find(r10, r11, r20, r21), next),
+                        advance(find(r11, r12, r21, r22), next));
+    if (fullStep) {
+        n->result = result;
+    } else {
+        n->slowResult = result;
+        n->slowLog2 = (int8_t)log2Gens;
+    }
+    return result;
+}
+
+// One generation of the 2x2 centre of a 4x4 node.
+HashLifeComputer::Node* HashLifeComputer::advanceBase(Node* n)
+{
+    // bits[y] holds row y of the 4x4 block, bit x is column x
+    uint32_t bits[4] = {0, 0, 0, 0};
+    Node* quads[4] = {n->nw, n->ne, n->sw, n->se};
+    for (int q = 0; q < 4; q++) {
+        int qx = (q & 1) * 2;
+        int qy = (q >> 1) * 2;
+        Node* leaves[4] = {quads[q]->nw, quads[q]->ne, quads[q]->sw, quads[q]->se};
+        for (int l = 0; l < 4; l++) {
+            if (leaves[l]->population) {
+                bits[qy + (l >> 1)] |= 1u << (qx + (l & 1));
+            }
+        }
+    }
+
+    Node* out[4];
+    for (int c = 0; c < 4; c++) {
+        int x = 1 + (c & 1);
+        int y = 1 + (c >> 1);
+        int neighbors = 0;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                if (dx == 0 && dy == 0) continue;
+                neighbors += (bits[y + dy] >> (x + dx)) & 1;
+            }
+        }
+        bool alive = (bits[y] >> x) & 1;
+        out[c] = (neighbors == 3 || (alive && neighbors == 2)) ? &m_alive : &m_dead;
+    }
+    return find(out[0], out[1], out[2], out[3]);
+}
+
+// Marks n, its quadrants and its memoized future, so the results of every
+// live node survive a collection along with the nodes themselves.
+void HashLifeComputer::mark(Node* n)
+{
+    if (n->level == 0 || n->marked) {
+        return;
+    }
+    n->marked = true;
+    mark(n->nw);
+    mark(n->ne);
+    mark(n->sw);
+    mark(n->se);
+    if (n->result) {
+        mark(n->result);
+    }
+    if (n->slowResult) {
+        mark(n->slowResult);
+    }
+}
+
+// Frees every node not reachable from the root or the empty-node cache,
+// either as a quadrant or as a memoized result. What the next steps will
+// ask for is the future of the current universe, which is all kept;
+// results only lost are those of universes the pattern has left behind.
+void HashLifeComputer::collectGarbage()
+{
+    mark(m_pRoot);
+    for (Node* e : m_empty) {
+        if (e) {
+            mark(e);
+        }
+    }
+
+    for (Node*& head : m_buckets) {
+        Node* kept = nullptr;
+        while (head) {
+            Node* next = head->hashNext;
+            if (head->marked) {
+                head->marked = false;
+                head->hashNext = kept;
+                kept = head;
+            } else {
+                head->hashNext = m_pFreeList;
+                m_pFreeList = head;
+                m_nodeCount--;
+            }
+            head = next;
+        }
+        head = kept;
+    }
+}
@@ -0,0 +1,87 @@
+//
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "cppSeed.hpp"
+#include "cppViewport.hpp"
+#include "cppPoints.hpp"
+
+// HashLife engine. The universe is a quadtree of hash-consed macrocells and
+// every macrocell memoizes its own future, so regular patterns can be
+// advanced 2^N generations per step. Unlike the grid engines the universe is
+// unbounded; render() clips to the rows x cols window it was created with.
+class HashLifeComputer
+{
+    struct Node
+    {
+        Node* nw;
+        Node* ne;
+        Node* sw;
+        Node* se;
+        Node* result;       // Centre advanced 2^(level-2) generations, the full step
+        Node* slowResult;   // Centre advanced 2^slowLog2 generations, a smaller step
+        Node* hashNext;     // Bucket chain, or free list link
+        uint64_t population;
+        int32_t level;      // Covers 2^level x 2^level cells
+        int8_t slowLog2;
+        bool marked;
+    };
+
+    Node m_dead{};
+    Node m_alive{};
+    Node* m_pRoot = nullptr;
+    std::vector<Node*> m_buckets;
+    std::vector<Node*> m_blocks;    // Node storage, released in the destructor
+    std::vector<Node*> m_empty;     // Canonical empty node per level
+    Node* m_pFreeList = nullptr;
+    size_t m_nodeCount = 0;
+    size_t m_gcThreshold = 0;
+    uint64_t m_generation = 0;
+
+    float *m_pAliveLocs = nullptr;  // i_0, j_0, i_1, j_1, ...
+    int64_t m_aliveCount = 0;     // Points written to m_pAliveLocs by the last render
+    int64_t m_aliveCapacity = 0;  // Floats allocated for m_pAliveLocs
+    GolViewport m_view{};  // Cells that get output points, see setViewport
+    int rows = 0;
+    int cols = 0;
+    double cellSize = 0;
+
+public:
+    HashLifeComputer(int32_t nRows, int32_t nCols, double cellSize, const void* cells = nullptr, int format = kCellFormatBytes);
+    ~HashLifeComputer();
+    bool step(int log2Gens);
+    void seed(uint32_t seed, double density);
+    void load(const void* cells, int format = kCellFormatBytes);
+    void setViewport(int x0, int y0, int x1, int y1);
+    void applyEdits(const int32_t* xy, const uint8_t* states, int n);
+    float* render();
+    uint64_t generation() const { return m_generation; }
+    uint64_t population() const { return m_pRoot->population; }
+    int64_t aliveCount() const { return m_aliveCount; }
+
+private:
+    void initData(const void* cells, int format);
+    void buildRoot(const uint8_t* grid);
+    Node* buildFromGrid(const uint8_t* grid, int level, int64_t x0, int64_t y0);
+
+    Node* allocNode();
+    Node* find(Node* nw, Node* ne, Node* sw, Node* se);
+    Node* empty(int level);
+    void rehash(size_t bucketCount);
+
+    Node* expand(Node* n);
+    bool isPadded(Node* n);
+    Node* advance(Node* n, int log2Gens);
+    Node* advanceBase(Node* n);
+    Node* centre(Node* n);
+
+    void collectGarbage();
+    void mark(Node* n);
+
+    Node* setCell(Node* n, int64_t x, int64_t y, uint8_t edit);
+    void reserveAlive(int64_t need, int64_t keep);
+    void setAliveCount(int64_t k);
+    int64_t viewPopulation(Node* n, int64_t x0, int64_t y0);
+    void renderNode(Node* n, int64_t x0, int64_t y0, int64_t& k, float halfCell);
+};
@@ -0,0 +1,73 @@
+#include <cstdint>
+#include "hashLifeComputer.hpp"
+#define EXPORT extern "C" __attribute__((visibility("default"))) __attribute__((used))
+
+HashLifeComputer* hashLifeComp = nullptr;
+
+EXPORT
+void initHashLife(int nRows, int nCols, double cellSize){
+    hashLifeComp = new HashLifeComputer(nRows, nCols, cellSize);
+}
+
+// Same as initHashLife, but starts from cells (rows * cols, in the GolCellFormat
+// given by format: 0 = bytes, 1 = bits, 2 = floats) instead of a random
+// soup. The cells are converted in one pass and not kept.
+EXPORT
+void initHashLifeFrom(int nRows, int nCols, double cellSize, const void* cells, int format){
+    hashLifeComp = new HashLifeComputer(nRows, nCols, cellSize, cells, format);
+}
+
+// Replaces the grid with a random soup; the same seed and density give
+// the same soup on every platform.
+EXPORT
+void seedHashLife(uint32_t seed, double density){
+    hashLifeComp->seed(seed, density);
+}
+
+// Replaces the grid with rows * cols bytes in row-major order, non-zero
+// meaning alive.
+EXPORT
+void loadCellsHashLife(const uint8_t* cells){
+    hashLifeComp->load(cells);
+}
+
+// Sets or toggles n cells between generations without rebuilding the
+// engine: cell (xy[2i], xy[2i+1]) takes states[i] (0 = dead, 1 = alive,
+// 2 = toggle). Cells outside the grid are ignored.
+EXPORT
+void applyEditsHashLife(const int32_t* xy, const uint8_t* states, int n){
+    hashLifeComp->applyEdits(xy, states, n);
+}
+
+// Restricts output to the cells in [x0, x1) x [y0, y1) (clipped to the
+// grid), e.g. the part that is on screen. Cells outside are still
+// simulated. Counts and buffers then cover the viewport only.
+EXPORT
+void setViewportHashLife(int x0, int y0, int x1, int y1){
+    hashLifeComp->setViewport(x0, y0, x1, y1);
+}
+
+// Advances 2^log2Gens generations in one call. Returns 0, or -1 without
+// stepping if log2Gens is over 59 or the universe cannot grow any further.
+EXPORT
+int stepHashLife(int log2Gens){
+    return hashLifeComp->step(log2Gens) ? 0 : -1;
+}
+
+EXPORT
+float* renderHashLife(){
+    auto retVal = hashLifeComp->render();
+    return retVal;
+}
+
+EXPORT
+uint64_t generationHashLife(){
+    return hashLifeComp->generation();
+}
+
+EXPORT
+void destructHashLife(){
+    delete hashLifeComp;
+    hashLifeComp = nullptr;
+}
+
@@ -1,6 +1,7 @@
 import 'package:flutter/material.dart';
 import 'package:game_of_life/game_of_life.dart';
 import 'dart:async';
+import 'package:game_of_life/data/gol_stats.dart';
 import 'package:game_of_life/data/update_type.dart';
 import 'package:circular_buffer/circular_buffer.dart';
 
@@ -43,6 +44,7 @@ class _GameScreenState extends State<GameScreen> {
       TransformationController();
   final fpsBuffer = CircularBuffer<double>(100);
   double averageFPS = 0;
+  PhaseTimes? phaseTimes; // Native engines only
 
   @override
   void initState() {
@@ -64,6 +66,10 @@ class _GameScreenState extends State<GameScreen> {
       if (fpsBuffer.isNotEmpty) {
         setState(() {
           averageFPS = fpsBuffer.reduce((a, b) => a + b) / fpsBuffer.length;
+          final stats = gameOfLife.golComputer.takeStats();
+          if (stats != null && stats.frames > 0) {
+            phaseTimes = stats;
+          }
         });
       }
     });
@@ -90,6 +96,16 @@ class _GameScreenState extends State<GameScreen> {
       appBar: AppBar(
         title: Text(
             'Game of Life: ${gameOfLife.golComputer.updateType.name}: ${averageFPS.toStringAsFixed(2)} FPS'),
+        bottom: phaseTimes == null
+            ? null
+            : PreferredSize(
+                preferredSize: const Size.fromHeight(20),
+                child: Padding(
+                  padding: const EdgeInsets.only(bottom: 4),
+                  child: Text(phaseTimes.toString(),
+                      style: Theme.of(context).textTheme.bodySmall),
+                ),
+              ),
       ),
       body: InteractiveViewer(
         onInteractionUpdate: (ScaleUpdateDetails details) {
@@ -1,3 +1,4 @@
+import 'dart:typed_data';
 import 'dart:ui' as ui;
 
 import 'package:flutter/material.dart';
@@ -21,11 +22,23 @@ class GameOfLifePainter extends CustomPainter {
       ..strokeWidth = cellSize;
 
     canvas.scale(scale);
+    // What is on screen, in the same units as the output points
+    golData.visibleRect = canvas.getLocalClipBounds();
+    golData.cellExtent = canvas.getTransform()[0] * cellSize;
     // canvas.translate(canvasOffset.dx,
     //     canvasOffset.dy); // Ensure 'offset' is an Offset object
     paint.color = Colors.black; // set the color for alive cells
 
+    if (golData.outputGrid.packedCells && golData.outputGrid.lodLevel == 0) {
+      paintCells(canvas, golData.outputGrid.cells, paint);
+      return;
+    }
     var outputData = golData.outputGrid.data;
+    final lodLevel = golData.outputGrid.lodLevel;
+    if (lodLevel > 0) {
+      paintDensity(canvas, outputData, lodLevel);
+      return;
+    }
     // Use drawRawPoints with the Float32List
     if (!debug) {
       canvas.drawRawPoints(ui.PointMode.points, outputData, paint);
@@ -34,7 +47,7 @@ class GameOfLifePainter extends CustomPainter {
       int k = 0;
 
       // Iterate over each cell in the grid
-      for (int y = 0; y < golData.rows * golData.columns; y++) {
+      for (int y = 0; y < outputData.length ~/ 2; y++) {
         var dx = outputData[k++];
         var dy = outputData[k++];
         canvas.drawRect(
@@ -45,6 +58,40 @@ class GameOfLifePainter extends CustomPainter {
     }
   }
 
+  /// Draws packed (column, row) cells. The engine left the scaling to the
+  /// consumer, so they are turned into cell centres here.
+  void paintCells(Canvas canvas, Uint16List cells, Paint paint) {
+    final points = Float32List(cells.length);
+    final halfCell = cellSize / 2;
+    for (int i = 0; i < cells.length; i++) {
+      points[i] = cells[i] * cellSize + halfCell;
+    }
+    canvas.drawRawPoints(ui.PointMode.points, points, paint);
+  }
+
+  /// Draws "x, y, weight" block points as squares of the block size.
+  /// drawRawPoints takes a single paint, so the blocks are binned by weight
+  /// into a few shades of the cell colour.
+  void paintDensity(Canvas canvas, Float32List data, int lodLevel) {
+    const shades = 4;
+    final bins = List.generate(shades, (_) => <double>[]);
+    for (int i = 0; i + 2 < data.length; i += 3) {
+      final shade = (data[i + 2] * shades).ceil().clamp(1, shades) - 1;
+      bins[shade]
+        ..add(data[i])
+        ..add(data[i + 1]);
+    }
+
+    final paint = Paint()
+      ..strokeCap = StrokeCap.square
+      ..strokeWidth = cellSize * (1 << lodLevel);
+    for (int shade = 0; shade < shades; shade++) {
+      paint.color = Colors.black.withOpacity((shade + 1) / shades);
+      canvas.drawRawPoints(
+          ui.PointMode.points, Float32List.fromList(bins[shade]), paint);
+    }
+  }
+
   @override
   bool shouldRepaint(covariant CustomPainter oldDelegate) {
     return true; // You might want to optimize this to reduce unnecessary repaints